@@ -0,0 +1,358 @@
+#ifndef _FFT_
+#define _FFT_
+
+#define _USE_MATH_DEFINES
+
+#include <complex>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+typedef std::complex< double > Base;
+
+// Ядра преобразования компилируются в нескольких вариантах под разные наборы инструкций,
+// нужный выбирается при загрузке программы (target_clones, GCC на x86-64 Linux).
+// В остальных случаях остается один вариант, который компилятор векторизует как сможет
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) && defined(__linux__)
+#define FFT_KERNEL __attribute__((target_clones("arch=skylake-avx512", "arch=haswell", "default")))
+#else
+#define FFT_KERNEL
+#endif
+
+// Слой длины 2, корни не нужны
+FFT_KERNEL
+void radix2Pass(double *__restrict re, double *__restrict im, size_t count) {
+    for (size_t i = 0; i < count; i += 2) {
+        double leftRe = re[i], leftIm = im[i];
+        re[i] = leftRe + re[i + 1];
+        im[i] = leftIm + im[i + 1];
+        re[i + 1] = leftRe - re[i + 1];
+        im[i + 1] = leftIm - im[i + 1];
+    }
+}
+
+// Два слоя радикса 2 (длины 2m и 4m) за один проход по памяти, прореживание по времени:
+// четверти блока x0..x3 - уже преобразованные части длины m в порядке обратных битов.
+// Корень слоя 4m для x3 - это корень для x2, умноженный на i, так что второй таблицы не нужно.
+// Корни слоя длины L лежат с места L / 2
+FFT_KERNEL
+void radix4Pass(double *__restrict re, double *__restrict im, size_t count, size_t m,
+                const double *__restrict rootsRe, const double *__restrict rootsIm) {
+    const double *halfRe = rootsRe + m, *halfIm = rootsIm + m;
+    const double *fullRe = rootsRe + 2 * m, *fullIm = rootsIm + 2 * m;
+    for (size_t block = 0; block < count; block += 4 * m) {
+        double *re0 = re + block, *re1 = re0 + m, *re2 = re1 + m, *re3 = re2 + m;
+        double *im0 = im + block, *im1 = im0 + m, *im2 = im1 + m, *im3 = im2 + m;
+        for (size_t j = 0; j < m; j++) {
+            // слой 2m: x1 и x3 умножаются на корень степени 2m
+            double t1Re = re1[j] * halfRe[j] - im1[j] * halfIm[j];
+            double t1Im = re1[j] * halfIm[j] + im1[j] * halfRe[j];
+            double t3Re = re3[j] * halfRe[j] - im3[j] * halfIm[j];
+            double t3Im = re3[j] * halfIm[j] + im3[j] * halfRe[j];
+            double b0Re = re0[j] + t1Re, b0Im = im0[j] + t1Im;
+            double b1Re = re0[j] - t1Re, b1Im = im0[j] - t1Im;
+            double b2Re = re2[j] + t3Re, b2Im = im2[j] + t3Im;
+            double b3Re = re2[j] - t3Re, b3Im = im2[j] - t3Im;
+            // слой 4m: b2 умножается на w, b3 - на i * w
+            double c2Re = b2Re * fullRe[j] - b2Im * fullIm[j];
+            double c2Im = b2Re * fullIm[j] + b2Im * fullRe[j];
+            double c3Re = -(b3Re * fullIm[j] + b3Im * fullRe[j]);
+            double c3Im = b3Re * fullRe[j] - b3Im * fullIm[j];
+            re0[j] = b0Re + c2Re;
+            im0[j] = b0Im + c2Im;
+            re2[j] = b0Re - c2Re;
+            im2[j] = b0Im - c2Im;
+            re1[j] = b1Re + c3Re;
+            im1[j] = b1Im + c3Im;
+            re3[j] = b1Re - c3Re;
+            im3[j] = b1Im - c3Im;
+        }
+    }
+}
+
+// Те же два слоя в обратном порядке, прореживание по частоте: из блока длины 4m в естественном
+// порядке получаются 4 блока длины m, которые дальше преобразуются независимо
+FFT_KERNEL
+void radix4PassDIF(double *__restrict re, double *__restrict im, size_t count, size_t m,
+                   const double *__restrict rootsRe, const double *__restrict rootsIm) {
+    const double *halfRe = rootsRe + m, *halfIm = rootsIm + m;
+    const double *fullRe = rootsRe + 2 * m, *fullIm = rootsIm + 2 * m;
+    for (size_t block = 0; block < count; block += 4 * m) {
+        double *re0 = re + block, *re1 = re0 + m, *re2 = re1 + m, *re3 = re2 + m;
+        double *im0 = im + block, *im1 = im0 + m, *im2 = im1 + m, *im3 = im2 + m;
+        for (size_t j = 0; j < m; j++) {
+            // слой 4m: пары (x0, x2) и (x1, x3), разности умножаются на w и i * w
+            double s0Re = re0[j] + re2[j], s0Im = im0[j] + im2[j];
+            double d0Re = re0[j] - re2[j], d0Im = im0[j] - im2[j];
+            double s1Re = re1[j] + re3[j], s1Im = im1[j] + im3[j];
+            double d1Re = re1[j] - re3[j], d1Im = im1[j] - im3[j];
+            double e0Re = d0Re * fullRe[j] - d0Im * fullIm[j];
+            double e0Im = d0Re * fullIm[j] + d0Im * fullRe[j];
+            double e1Re = -(d1Re * fullIm[j] + d1Im * fullRe[j]);
+            double e1Im = d1Re * fullRe[j] - d1Im * fullIm[j];
+            // слой 2m: пары (s0, s1) и (e0, e1), разности умножаются на корень степени 2m
+            double f0Re = s0Re - s1Re, f0Im = s0Im - s1Im;
+            double f1Re = e0Re - e1Re, f1Im = e0Im - e1Im;
+            re0[j] = s0Re + s1Re;
+            im0[j] = s0Im + s1Im;
+            re1[j] = f0Re * halfRe[j] - f0Im * halfIm[j];
+            im1[j] = f0Re * halfIm[j] + f0Im * halfRe[j];
+            re2[j] = e0Re + e1Re;
+            im2[j] = e0Im + e1Im;
+            re3[j] = f1Re * halfRe[j] - f1Im * halfIm[j];
+            im3[j] = f1Re * halfIm[j] + f1Im * halfRe[j];
+        }
+    }
+}
+
+// План преобразования фиксированного размера (степень 2-и): перестановка с обратными битами
+// и корни из 1 считаются один раз в конструкторе.
+// Корни берутся прямо из cos и sin, а не степенями одного корня, поэтому ошибка не копится с ростом n.
+// Основной вид данных - раздельные массивы действительных и мнимых частей; слои радикса 4,
+// а слои до длины BLOCK проходятся поблочно, пока блок лежит в кэше.
+// Для сверток есть пара forwardBitReversed / inverseBitReversed без перестановки: прямое
+// прореживанием по частоте оставляет результат в порядке обратных битов, обратное прореживанием
+// по времени как раз такой порядок и принимает, а поэлементному умножению порядок не важен
+class FFTPlan {
+    enum { BLOCK = 1 << 12 };
+
+    size_t size_;
+    // при нечетном log n первый слой - радикса 2
+    bool oddLog;
+    // reversed[i] - i с битами в обратном порядке
+    std::vector< size_t > reversed;
+    // корни для слоя длины length лежат подряд с места length / 2: exp(2 pi i j / length)
+    std::vector< double > rootsRe, rootsIm;
+
+    // слои от длины from до длины to на count элементах; from и to - длины из последовательности слоев
+    void runStages(double *re, double *im, size_t count, size_t from, size_t to) const {
+        size_t length = from;
+        if (length == 1 && oddLog && to >= 2) {
+            radix2Pass(re, im, count);
+            length = 2;
+        }
+        for (; length * 4 <= to; length *= 4)
+            radix4Pass(re, im, count, length, &rootsRe[0], &rootsIm[0]);
+    }
+
+    // то же прореживанием по частоте: слои от длины from вниз до длины to
+    void runStagesDIF(double *re, double *im, size_t count, size_t from, size_t to) const {
+        size_t length = from;
+        for (; length / 4 >= to && length / 4 >= (oddLog ? 2 : 1); length /= 4)
+            radix4PassDIF(re, im, count, length / 4, &rootsRe[0], &rootsIm[0]);
+        if (length == 2 && to == 1)
+            radix2Pass(re, im, count);
+    }
+
+    // наибольшая длина из последовательности слоев, не больше BLOCK
+    size_t blockSize() const {
+        size_t block = oddLog ? 2 : 1;
+        while (block * 4 <= std::min(size_, (size_t) BLOCK))
+            block *= 4;
+        return block;
+    }
+
+    // прямое преобразование с корнями exp(+2 pi i / n), как в DFT, из порядка обратных битов в естественный
+    void transform(double *re, double *im) const {
+        size_t block = blockSize();
+        for (size_t offset = 0; offset < size_; offset += block)
+            runStages(re + offset, im + offset, block, 1, block);
+        runStages(re, im, size_, block, size_);
+    }
+
+    // оно же из естественного порядка в порядок обратных битов
+    void transformDIF(double *re, double *im) const {
+        size_t block = blockSize();
+        runStagesDIF(re, im, size_, size_, block);
+        for (size_t offset = 0; offset < size_; offset += block)
+            runStagesDIF(re + offset, im + offset, block, block, 1);
+    }
+
+    void permute(double *re, double *im) const {
+        for (size_t i = 0; i < size_; i++)
+            if (i < reversed[i]) {
+                std::swap(re[i], re[reversed[i]]);
+                std::swap(im[i], im[reversed[i]]);
+            }
+    }
+
+    // обратное через прямое: conj(DFT(conj(x))) / n
+    void transformInverse(double *re, double *im) const {
+        conjugate(im);
+        transform(re, im);
+        for (size_t i = 0; i < size_; i++) {
+            re[i] /= size_;
+            im[i] = -im[i] / size_;
+        }
+    }
+
+    void conjugate(double *im) const {
+        for (size_t i = 0; i < size_; i++)
+            im[i] = -im[i];
+    }
+
+public:
+    explicit FFTPlan(size_t size):
+        size_(size),
+        oddLog(false),
+        reversed(size, 0),
+        rootsRe(std::max(size, (size_t) 1)),
+        rootsIm(std::max(size, (size_t) 1)) {
+        size_t logSize = 0;
+        while ((1UL << logSize) < size)
+            logSize++;
+        oddLog = logSize % 2;
+        for (size_t i = 1; i < size; i++)
+            reversed[i] = (reversed[i >> 1] >> 1) | ((i & 1) << (logSize - 1));
+        for (size_t length = 2; length <= size; length *= 2)
+            for (size_t j = 0; j < length / 2; j++) {
+                double angle = 2 * M_PI * j / length;
+                rootsRe[length / 2 + j] = cos(angle);
+                rootsIm[length / 2 + j] = sin(angle);
+            }
+    }
+
+    size_t size() const {
+        return size_;
+    }
+
+    // где после forwardBitReversed лежит частота frequency
+    size_t bitReversed(size_t frequency) const {
+        return reversed[frequency];
+    }
+
+    // re и im размера плана; по указателям - например, строки матрицы в ParallelFFT
+    void forward(double *re, double *im) const {
+        if (size_ <= 1)
+            return;
+        permute(re, im);
+        transform(re, im);
+    }
+
+    void inverse(double *re, double *im) const {
+        if (size_ <= 1)
+            return;
+        permute(re, im);
+        transformInverse(re, im);
+    }
+
+    void forward(std::vector< double > &re, std::vector< double > &im) const {
+        forward(&re[0], &im[0]);
+    }
+
+    void inverse(std::vector< double > &re, std::vector< double > &im) const {
+        inverse(&re[0], &im[0]);
+    }
+
+    // прямое с результатом в порядке обратных битов
+    void forwardBitReversed(std::vector< double > &re, std::vector< double > &im) const {
+        if (size_ > 1)
+            transformDIF(&re[0], &im[0]);
+    }
+
+    // обратное к forwardBitReversed: вход в порядке обратных битов, результат в естественном
+    void inverseBitReversed(std::vector< double > &re, std::vector< double > &im) const {
+        if (size_ > 1)
+            transformInverse(&re[0], &im[0]);
+    }
+
+    // то же для комплексного вектора: данные перекладываются в раздельные массивы и обратно
+    void forward(std::vector< Base > &v) const {
+        std::vector< double > re(size_), im(size_);
+        for (size_t i = 0; i < size_; i++) {
+            re[i] = v[i].real();
+            im[i] = v[i].imag();
+        }
+        forward(re, im);
+        for (size_t i = 0; i < size_; i++)
+            v[i] = Base(re[i], im[i]);
+    }
+
+    void inverse(std::vector< Base > &v) const {
+        std::vector< double > re(size_), im(size_);
+        for (size_t i = 0; i < size_; i++) {
+            re[i] = v[i].real();
+            im[i] = v[i].imag();
+        }
+        inverse(re, im);
+        for (size_t i = 0; i < size_; i++)
+            v[i] = Base(re[i], im[i]);
+    }
+};
+
+void DFT(std::vector< Base > &v) {
+    FFTPlan(v.size()).forward(v);
+}
+
+void inverseDFT(std::vector< Base > &v) {
+    FFTPlan(v.size()).inverse(v);
+}
+
+// свертка a и b в mult, все трое размера плана; a и b портятся (в них остаются образы в порядке
+// обратных битов)
+void multiply(const FFTPlan &plan, std::vector< Base > &a, std::vector< Base > &b, std::vector< Base > &mult) {
+    size_t n = plan.size();
+    std::vector< double > aRe(n), aIm(n), bRe(n), bIm(n);
+    for (size_t i = 0; i < n; i++) {
+        aRe[i] = a[i].real();
+        aIm[i] = a[i].imag();
+        bRe[i] = b[i].real();
+        bIm[i] = b[i].imag();
+    }
+    plan.forwardBitReversed(aRe, aIm);
+    plan.forwardBitReversed(bRe, bIm);
+    for (size_t i = 0; i < n; i++) {
+        a[i] = Base(aRe[i], aIm[i]);
+        b[i] = Base(bRe[i], bIm[i]);
+        Base product = a[i] * b[i];
+        aRe[i] = product.real();
+        aIm[i] = product.imag();
+    }
+    plan.inverseBitReversed(aRe, aIm);
+    for (size_t i = 0; i < n; i++)
+        mult[i] = Base(aRe[i], aIm[i]);
+}
+
+// Шаг multiplyRealPairs для пары частот: в p лежит частота k образов first и second, в q - частота
+// n - k. Образ действительного сигнала сопряженно-симметричен, поэтому образы a и a2 разделяются из
+// образа a + i a2: A[k] = (Z[k] + conj(Z[n - k])) / 2, A2[k] = (Z[k] - conj(Z[n - k])) / 2i.
+// В first на p и q кладутся частоты k и n - k произведения A B + i A2 B2 - образа a * b + i (a2 * b2)
+inline void combineRealPairs(std::vector< double > &firstRe, std::vector< double > &firstIm,
+                             const std::vector< double > &secondRe, const std::vector< double > &secondIm,
+                             size_t p, size_t q) {
+    Base first(firstRe[p], firstIm[p]), firstPair = std::conj(Base(firstRe[q], firstIm[q]));
+    Base second(secondRe[p], secondIm[p]), secondPair = std::conj(Base(secondRe[q], secondIm[q]));
+    Base a = (first + firstPair) * 0.5, a2 = (first - firstPair) * Base(0, -0.5);
+    Base b = (second + secondPair) * 0.5, b2 = (second - secondPair) * Base(0, -0.5);
+    // в частоте n - k образы сопряжены
+    Base product = a * b + Base(0, 1) * (a2 * b2);
+    Base productPair = std::conj(a * b) + Base(0, 1) * std::conj(a2 * b2);
+    firstRe[p] = product.real();
+    firstIm[p] = product.imag();
+    firstRe[q] = productPair.real();
+    firstIm[q] = productPair.imag();
+}
+
+// Две свертки действительных сигналов за 3 преобразования вместо 6: на входе в first лежат a
+// (re) и a2 (im), в second - b и b2, на выходе first.re = a * b, first.im = a2 * b2, second портится.
+// Образы разделяются и перемножаются в combineRealPairs, произведение обращается одним преобразованием.
+// Никаких буферов внутри: вызывающий может держать четыре массива и использовать их снова
+void multiplyRealPairs(const FFTPlan &plan, std::vector< double > &firstRe, std::vector< double > &firstIm,
+                       std::vector< double > &secondRe, std::vector< double > &secondIm) {
+    size_t n = plan.size();
+    plan.forwardBitReversed(firstRe, firstIm);
+    plan.forwardBitReversed(secondRe, secondIm);
+    for (size_t p = 0; p < n; p++) {
+        // q - место частоты n - k, если в p лежит частота k
+        size_t q = plan.bitReversed((n - plan.bitReversed(p)) & (n - 1));
+        if (q >= p)
+            combineRealPairs(firstRe, firstIm, secondRe, secondIm, p, q);
+    }
+    plan.inverseBitReversed(firstRe, firstIm);
+}
+
+void multiply(std::vector< Base > &a, std::vector< Base > &b, std::vector< Base > &mult) {
+    multiply(FFTPlan(a.size()), a, b, mult);
+}
+
+#endif
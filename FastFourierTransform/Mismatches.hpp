@@ -0,0 +1,85 @@
+#ifndef _MISMATCHES_
+#define _MISMATCHES_
+
+#include <string>
+#include <vector>
+
+#include "NTT.hpp"
+
+// Число несовпадений образца с каждой позицией текста над произвольным байтовым алфавитом.
+// Для каждого символа c образца совпадения c в окне i - это свертка индикаторов [text = c] и
+// развернутого [pattern = c], так что совпадения всех символов - сумма сверток. Суммируются образы,
+// поэтому на символ нужно два прямых преобразования, а обратное одно на всех: O(s * n log n), где
+// s - число различных символов образца (остальные ни с чем не совпадают).
+// Джокер совпадает с любым символом и в тексте, и в образце: учитываются только позиции, где джокеров
+// нет, их число - еще одна такая же свертка. Считается через NTT, так что ответ точный.
+// Длина преобразования ограничена NTT_MAX_SIZE, поэтому длинный текст режется на куски, соседние
+// перекрываются на |pattern| - 1 букв, и каждое окно целиком попадает в какой-то кусок.
+// mismatches[i] - несовпадения pattern с text[i..i + |pattern|), i от 0 до |text| - |pattern|;
+// wildcard < 0 - без джокеров. false, если образец длиннее половины NTT_MAX_SIZE и резать бесполезно
+bool countMismatches(const std::string &text, const std::string &pattern, std::vector< size_t > &mismatches,
+                     int wildcard = -1) {
+    mismatches.clear();
+    if (pattern.empty() || pattern.size() > text.size())
+        return true;
+    size_t n = 1;
+    while (n < text.size() + pattern.size() - 1 && n < NTT_MAX_SIZE)
+        n *= 2;
+    if (n < text.size() + pattern.size() - 1 && 2 * pattern.size() > n)
+        return false;
+    // совпадений в окне не больше |pattern| < n, так что хватает одного модуля, поддерживающего размер n
+    size_t prime = 0;
+    while (!nttSupports(n, NTT_PRIMES[prime].mod))
+        prime++;
+    NTTPlan plan(n, NTT_PRIMES[prime].mod, NTT_PRIMES[prime].generator);
+    std::vector< bool > used(1 << (8 * sizeof(char)), false);
+    for (size_t i = 0; i < pattern.size(); i++)
+        used[(unsigned char) pattern[i]] = true;
+    if (wildcard >= 0)
+        used[wildcard] = false;
+    mismatches.resize(text.size() - pattern.size() + 1);
+    // кусок текста - n - |pattern| + 1 букв, тогда свертка с образцом не заворачивается по модулю n
+    size_t length = n - pattern.size() + 1, windows = length - pattern.size() + 1;
+    size_t chunks = (mismatches.size() + windows - 1) / windows;
+    // Образ образца от куска не зависит, поэтому снаружи цикл по символам, внутри - по кускам, и на
+    // каждый кусок копится своя сумма образов. Сумм chunks * n = O(|text|), не больше самого ответа
+    std::vector< std::vector< unsigned int > > matches(chunks, std::vector< unsigned int >(n, 0));
+    std::vector< std::vector< unsigned int > > cared(wildcard >= 0 ? chunks : 0, std::vector< unsigned int >(n, 0));
+    std::vector< unsigned int > textSignal(n), patternSignal(n);
+    // symbol = -1 - индикаторы позиций без джокера
+    for (int symbol = -1; symbol < (int) used.size(); symbol++) {
+        if (symbol < 0 ? wildcard < 0 : !used[symbol])
+            continue;
+        for (size_t i = 0; i < n; i++) {
+            unsigned char letter = i < pattern.size() ? pattern[pattern.size() - 1 - i] : 0;
+            patternSignal[i] = i < pattern.size() && (symbol < 0 ? letter != wildcard : letter == symbol);
+        }
+        plan.forwardBitReversed(patternSignal);
+        for (size_t chunk = 0; chunk < chunks; chunk++) {
+            size_t begin = chunk * windows, end = std::min(begin + length, text.size());
+            for (size_t i = 0; i < n; i++) {
+                unsigned char letter = begin + i < end ? text[begin + i] : 0;
+                textSignal[i] = begin + i < end && (symbol < 0 ? letter != wildcard : letter == symbol);
+            }
+            plan.forwardBitReversed(textSignal);
+            plan.multiplyAccumulate(symbol < 0 ? cared[chunk] : matches[chunk], textSignal, patternSignal);
+        }
+    }
+    for (size_t chunk = 0; chunk < chunks; chunk++) {
+        plan.inverseBitReversed(matches[chunk]);
+        if (wildcard >= 0)
+            plan.inverseBitReversed(cared[chunk]);
+        size_t begin = chunk * windows;
+        for (size_t i = begin; i < mismatches.size() && i < begin + windows; i++) {
+            size_t last = i - begin + pattern.size() - 1;
+            mismatches[i] = (wildcard >= 0 ? cared[chunk][last] : pattern.size()) - matches[chunk][last];
+        }
+        // сумма куска больше не нужна
+        std::vector< unsigned int >().swap(matches[chunk]);
+        if (wildcard >= 0)
+            std::vector< unsigned int >().swap(cared[chunk]);
+    }
+    return true;
+}
+
+#endif
@@ -0,0 +1,246 @@
+#ifndef _NTT_
+#define _NTT_
+
+#include <vector>
+#include <algorithm>
+#include <cassert>
+
+#include "FFT.hpp"
+
+// Теоретико-числовое преобразование: то же БПФ, но в поле вычетов по простому модулю вида c * 2^k + 1,
+// где есть корни из 1 степени 2^k. Ошибок округления нет, свертка получается точно по модулю.
+// Умножение по Монтгомери: x * y / 2^32 mod p без деления, модуль меньше 2^30.
+// Ядра, как и у FFT, - простые циклы, которые компилятор векторизует под нужные инструкции
+
+// t * 2^-32 mod p для t < p * 2^32; modInverse = -p^-1 mod 2^32
+inline unsigned int montgomeryReduce(unsigned long long t, unsigned int mod, unsigned int modInverse) {
+    unsigned int m = (unsigned int) t * modInverse;
+    unsigned int result = (t + (unsigned long long) m * mod) >> 32;
+    return result >= mod ? result - mod : result;
+}
+
+// слой длины 2 * half прореживанием по частоте; корни в форме Монтгомери, как у FFTPlan с места half
+FFT_KERNEL
+void nttPassDIF(unsigned int *__restrict a, size_t count, size_t half, const unsigned int *__restrict roots,
+                unsigned int mod, unsigned int modInverse) {
+    for (size_t block = 0; block < count; block += 2 * half) {
+        unsigned int *left = a + block, *right = left + half;
+        for (size_t j = 0; j < half; j++) {
+            unsigned int u = left[j], v = right[j];
+            unsigned int sum = u + v;
+            left[j] = sum >= mod ? sum - mod : sum;
+            right[j] = montgomeryReduce((unsigned long long) (u + mod - v) * roots[half + j], mod, modInverse);
+        }
+    }
+}
+
+// слой длины 2 * half прореживанием по времени
+FFT_KERNEL
+void nttPassDIT(unsigned int *__restrict a, size_t count, size_t half, const unsigned int *__restrict roots,
+                unsigned int mod, unsigned int modInverse) {
+    for (size_t block = 0; block < count; block += 2 * half) {
+        unsigned int *left = a + block, *right = left + half;
+        for (size_t j = 0; j < half; j++) {
+            unsigned int u = left[j];
+            unsigned int v = montgomeryReduce((unsigned long long) right[j] * roots[half + j], mod, modInverse);
+            unsigned int sum = u + v;
+            left[j] = sum >= mod ? sum - mod : sum;
+            right[j] = u >= v ? u - v : u + mod - v;
+        }
+    }
+}
+
+// a[i] = a[i] * b[i] / 2^32 mod p
+FFT_KERNEL
+void nttPointwise(unsigned int *__restrict a, const unsigned int *__restrict b, size_t count,
+                  unsigned int mod, unsigned int modInverse) {
+    for (size_t i = 0; i < count; i++)
+        a[i] = montgomeryReduce((unsigned long long) a[i] * b[i], mod, modInverse);
+}
+
+// sum[i] += a[i] * b[i] / 2^32 mod p
+FFT_KERNEL
+void nttMultiplyAdd(unsigned int *__restrict sum, const unsigned int *__restrict a, const unsigned int *__restrict b,
+                    size_t count, unsigned int mod, unsigned int modInverse) {
+    for (size_t i = 0; i < count; i++) {
+        unsigned int value = sum[i] + montgomeryReduce((unsigned long long) a[i] * b[i], mod, modInverse);
+        sum[i] = value >= mod ? value - mod : value;
+    }
+}
+
+unsigned int powerMod(unsigned long long base, unsigned long long power, unsigned int mod) {
+    unsigned long long result = 1;
+    base %= mod;
+    for (; power; power /= 2) {
+        if (power % 2)
+            result = result * base % mod;
+        base = base * base % mod;
+    }
+    return result;
+}
+
+// Простые модули вида c * 2^k + 1 меньше 2^30, как требует умножение по Монтгомери, и их первообразные
+// корни. NTT размера n по модулю p есть, только если n делит p - 1: 998244353 дает до 2^23,
+// 754974721 - до 2^24, 167772161 - до 2^25, 469762049 - до 2^26. Длиннее в таких модулях не бывает
+struct NTTPrime {
+    unsigned int mod;
+    unsigned int generator;
+};
+
+const NTTPrime NTT_PRIMES[] = { { 998244353, 3 }, { 469762049, 3 }, { 167772161, 3 }, { 754974721, 11 } };
+const size_t NTT_PRIMES_NUMBER = sizeof(NTT_PRIMES) / sizeof(NTT_PRIMES[0]);
+const size_t NTT_MAX_SIZE = 1 << 26;
+
+// есть ли NTT размера size (степень 2-и) по модулю mod
+inline bool nttSupports(size_t size, unsigned int mod) {
+    return size <= 1 || (mod - 1) % size == 0;
+}
+
+// План NTT размера size (степень 2-и, делит p - 1) по модулю mod с первообразным корнем generator.
+// Как у FFTPlan, прямое оставляет образ в порядке обратных битов, обратное его принимает.
+// Образы перемножаются через multiplyPointwise; обратное учитывает лишний множитель 2^-32 этого
+// произведения, так что forward, multiplyPointwise и inverse вместе дают свертку по модулю p
+class NTTPlan {
+    size_t size_;
+    unsigned int mod;
+    unsigned int modInverse;
+    // n^-1 * 2^64 mod p: после обратного преобразования делит на n и снимает 2^-32 от произведения
+    unsigned int scale;
+    std::vector< unsigned int > roots, inverseRoots;
+
+    // x * 2^32 mod p
+    unsigned int toMontgomery(unsigned long long x) const {
+        return (x << 32) % mod;
+    }
+
+public:
+    NTTPlan(size_t size, unsigned int mod, unsigned int generator):
+        size_(size),
+        mod(mod),
+        roots(std::max(size, (size_t) 1)),
+        inverseRoots(std::max(size, (size_t) 1)) {
+        // иначе (mod - 1) / length ниже округляется и корни получаются не той степени
+        assert(nttSupports(size, mod));
+        // обратный к mod по модулю 2^32 методом Ньютона
+        unsigned int inverse = mod;
+        for (int i = 0; i < 5; i++)
+            inverse *= 2 - mod * inverse;
+        modInverse = -inverse;
+        for (size_t length = 2; length <= size; length *= 2) {
+            unsigned int root = powerMod(generator, (mod - 1) / length, mod);
+            unsigned int inverseRoot = powerMod(root, mod - 2, mod);
+            unsigned long long power = 1, inversePower = 1;
+            for (size_t j = 0; j < length / 2; j++) {
+                roots[length / 2 + j] = toMontgomery(power);
+                inverseRoots[length / 2 + j] = toMontgomery(inversePower);
+                power = power * root % mod;
+                inversePower = inversePower * inverseRoot % mod;
+            }
+        }
+        unsigned long long shift = (1ULL << 32) % mod;
+        scale = shift * shift % mod * powerMod(size, mod - 2, mod) % mod;
+    }
+
+    size_t size() const {
+        return size_;
+    }
+
+    unsigned int modulus() const {
+        return mod;
+    }
+
+    // a размера плана, значения меньше модуля
+    void forwardBitReversed(std::vector< unsigned int > &a) const {
+        for (size_t half = size_ / 2; half >= 1; half /= 2)
+            nttPassDIF(&a[0], size_, half, &roots[0], mod, modInverse);
+    }
+
+    void multiplyPointwise(std::vector< unsigned int > &a, const std::vector< unsigned int > &b) const {
+        nttPointwise(&a[0], &b[0], size_, mod, modInverse);
+    }
+
+    // sum += a * b поэлементно: сумма произведений образов - образ суммы сверток, обращать ее можно один раз
+    void multiplyAccumulate(std::vector< unsigned int > &sum, const std::vector< unsigned int > &a,
+                            const std::vector< unsigned int > &b) const {
+        nttMultiplyAdd(&sum[0], &a[0], &b[0], size_, mod, modInverse);
+    }
+
+    void inverseBitReversed(std::vector< unsigned int > &a) const {
+        for (size_t half = 1; half < size_; half *= 2)
+            nttPassDIT(&a[0], size_, half, &inverseRoots[0], mod, modInverse);
+        for (size_t i = 0; i < size_; i++)
+            a[i] = montgomeryReduce((unsigned long long) a[i] * scale, mod, modInverse);
+    }
+};
+
+// свертка по модулю plan.modulus(), |mult| = |a| + |b| - 1
+void multiplyModulo(const NTTPlan &plan, const std::vector< unsigned int > &a, const std::vector< unsigned int > &b,
+                    std::vector< unsigned int > &mult) {
+    std::vector< unsigned int > other(plan.size(), 0);
+    mult.assign(plan.size(), 0);
+    for (size_t i = 0; i < a.size(); i++)
+        mult[i] = a[i] % plan.modulus();
+    for (size_t i = 0; i < b.size(); i++)
+        other[i] = b[i] % plan.modulus();
+    plan.forwardBitReversed(mult);
+    plan.forwardBitReversed(other);
+    plan.multiplyPointwise(mult, other);
+    plan.inverseBitReversed(mult);
+    mult.resize(a.size() + b.size() - 1);
+}
+
+// Точное произведение многочленов с неотрицательными коэффициентами, |mult| = |a| + |b| - 1.
+// Коэффициенты не больше min(|a|, |b|) * max a * max b; по этой оценке берется столько простых
+// модулей из NTT_PRIMES, поддерживающих размер преобразования (до трех, их произведение больше 2^85),
+// сколько нужно, и результат восстанавливается по китайской теореме об остатках (Гарнер).
+// Результат восстанавливается в 64 битах, поэтому оценка должна быть меньше 2^64. Чем длиннее
+// преобразование, тем меньше подходящих модулей. false, если оценка не меньше 2^64, модулей не хватает
+// на нее или размер больше NTT_MAX_SIZE; mult тогда пуст
+bool multiply(const std::vector< unsigned int > &a, const std::vector< unsigned int > &b,
+              std::vector< unsigned long long > &mult) {
+    mult.clear();
+    if (a.empty() || b.empty())
+        return true;
+    size_t n = 1;
+    while (n < a.size() + b.size() - 1)
+        n *= 2;
+    long double bound = (long double) std::min(a.size(), b.size()) * *std::max_element(a.begin(), a.end())
+        * *std::max_element(b.begin(), b.end());
+    // иначе Гарнер молча вернет коэффициенты по модулю 2^64
+    if (bound >= 18446744073709551616.0L)
+        return false;
+    NTTPrime primes[3];
+    size_t moduli = 0;
+    long double product = 1;
+    for (size_t i = 0; i < NTT_PRIMES_NUMBER && moduli < 3 && (moduli == 0 || bound >= product); i++)
+        if (nttSupports(n, NTT_PRIMES[i].mod)) {
+            primes[moduli++] = NTT_PRIMES[i];
+            product *= NTT_PRIMES[i].mod;
+        }
+    if (moduli == 0 || bound >= product)
+        return false;
+    std::vector< unsigned int > residues[3];
+    for (size_t i = 0; i < moduli; i++)
+        multiplyModulo(NTTPlan(n, primes[i].mod, primes[i].generator), a, b, residues[i]);
+    mult.assign(residues[0].begin(), residues[0].end());
+    if (moduli == 1)
+        return true;
+    // x = r0 + p0 * t1 + p0 * p1 * t2; в 64 битах считается по модулю 2^64, этого и хватает
+    unsigned long long p0 = primes[0].mod, p1 = primes[1].mod, p2 = moduli == 3 ? primes[2].mod : 1;
+    unsigned long long inverse01 = powerMod(p0, p1 - 2, p1);
+    unsigned long long inverse012 = moduli == 3 ? powerMod(p0 * p1 % p2, p2 - 2, p2) : 0;
+    for (size_t i = 0; i < mult.size(); i++) {
+        unsigned long long r0 = residues[0][i], r1 = residues[1][i];
+        unsigned long long t1 = (r1 + p1 - r0 % p1) % p1 * inverse01 % p1;
+        mult[i] = r0 + p0 * t1;
+        if (moduli == 3) {
+            unsigned long long r2 = residues[2][i];
+            unsigned long long known = (r0 + p0 % p2 * t1) % p2;
+            unsigned long long t2 = (r2 + p2 - known) % p2 * inverse012 % p2;
+            mult[i] += p0 * p1 * t2;
+        }
+    }
+    return true;
+}
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef _OVERLAP_SAVE_
+#define _OVERLAP_SAVE_
+
+#include <vector>
+#include <algorithm>
+
+#include "FFT.hpp"
+
+// Корреляция бесконечного потока с фиксированным образцом методом перекрытия с сохранением.
+// score[i] = sum_j pattern[j] * stream[i + j] для всех окон, целиком пришедших в поток.
+// Образ развернутого образца считается один раз. Поток режется на блоки: в буфере размера преобразования
+// n лежат последние m - 1 отсчетов прошлого блока и n - m + 1 новых, циклическая свертка буфера с
+// образцом верна как раз в последних n - m + 1 точках - это оценки окон, начинающихся в блоке.
+// Память O(n) независимо от длины потока
+class OverlapSave {
+    size_t patternSize;
+    FFTPlan plan;
+    // образ развернутого образца в порядке обратных битов
+    std::vector< double > patternRe, patternIm;
+    // буфер отсчетов и сколько в нем лежит
+    std::vector< double > buffer;
+    size_t filled;
+    std::vector< double > re, im;
+
+    static size_t planSize(size_t patternSize, size_t blockSize) {
+        size_t n = 1;
+        while (n < std::max(blockSize, (size_t) 1) + patternSize - 1)
+            n *= 2;
+        return n;
+    }
+
+    // оценки окон, начинающихся в первых count - m + 1 отсчетах буфера
+    void process(size_t count, std::vector< double > &scores) {
+        std::copy(buffer.begin(), buffer.begin() + count, re.begin());
+        std::fill(re.begin() + count, re.end(), 0);
+        std::fill(im.begin(), im.end(), 0);
+        plan.forwardBitReversed(re, im);
+        for (size_t i = 0; i < plan.size(); i++) {
+            double valueRe = re[i];
+            re[i] = valueRe * patternRe[i] - im[i] * patternIm[i];
+            im[i] = valueRe * patternIm[i] + im[i] * patternRe[i];
+        }
+        plan.inverseBitReversed(re, im);
+        scores.insert(scores.end(), re.begin() + patternSize - 1, re.begin() + count);
+    }
+
+public:
+    // blockSize - сколько новых отсчетов обрабатывается за одно преобразование
+    OverlapSave(const std::vector< double > &pattern, size_t blockSize = 1 << 16):
+        patternSize(std::max(pattern.size(), (size_t) 1)),
+        plan(planSize(patternSize, blockSize)),
+        patternRe(plan.size(), 0),
+        patternIm(plan.size(), 0),
+        buffer(plan.size()),
+        filled(0),
+        re(plan.size()),
+        im(plan.size()) {
+        for (size_t i = 0; i < pattern.size(); i++)
+            patternRe[pattern.size() - 1 - i] = pattern[i];
+        plan.forwardBitReversed(patternRe, patternIm);
+    }
+
+    // дописывает отсчеты в поток, оценки готовых окон добавляются в scores по порядку
+    void push(const double *samples, size_t count, std::vector< double > &scores) {
+        while (count > 0) {
+            size_t taken = std::min(count, buffer.size() - filled);
+            std::copy(samples, samples + taken, buffer.begin() + filled);
+            filled += taken;
+            samples += taken;
+            count -= taken;
+            if (filled == buffer.size()) {
+                process(filled, scores);
+                // последние m - 1 отсчетов нужны окнам следующего блока
+                std::copy(buffer.end() - (patternSize - 1), buffer.end(), buffer.begin());
+                filled = patternSize - 1;
+            }
+        }
+    }
+
+    // оценки окон, которые уже целиком пришли, но еще не выданы
+    void flush(std::vector< double > &scores) {
+        if (filled >= patternSize) {
+            process(filled, scores);
+            std::copy(buffer.begin() + filled - (patternSize - 1), buffer.begin() + filled, buffer.begin());
+            filled = patternSize - 1;
+        }
+    }
+
+    size_t blockSize() const {
+        return plan.size() - patternSize + 1;
+    }
+};
+
+#endif
@@ -0,0 +1,179 @@
+#ifndef _PARALLEL_FFT_
+#define _PARALLEL_FFT_
+
+#include <vector>
+#include <thread>
+#include <algorithm>
+
+#include "FFT.hpp"
+#include "../Parallel/ParallelFor.hpp"
+
+// Многопоточность для FFT (нужны -std=c++11 -pthread): наборы сигналов и одно большое преобразование
+
+// прямое преобразование каждого сигнала набора одного размера, сигналы раздаются потокам
+void forwardBatch(const FFTPlan &plan, std::vector< std::vector< double > > &re,
+                  std::vector< std::vector< double > > &im,
+                  size_t threadsNumber = std::thread::hardware_concurrency()) {
+    parallelFor(re.size(), threadsNumber, [&](size_t i) {
+        plan.forward(re[i], im[i]);
+    });
+}
+
+void inverseBatch(const FFTPlan &plan, std::vector< std::vector< double > > &re,
+                  std::vector< std::vector< double > > &im,
+                  size_t threadsNumber = std::thread::hardware_concurrency()) {
+    parallelFor(re.size(), threadsNumber, [&](size_t i) {
+        plan.inverse(re[i], im[i]);
+    });
+}
+
+// свертки пар a[i], b[i] в mult[i], как multiply, по потокам
+void multiplyBatch(const FFTPlan &plan, std::vector< std::vector< Base > > &a, std::vector< std::vector< Base > > &b,
+                   std::vector< std::vector< Base > > &mult,
+                   size_t threadsNumber = std::thread::hardware_concurrency()) {
+    mult.resize(a.size(), std::vector< Base >(plan.size()));
+    parallelFor(a.size(), threadsNumber, [&](size_t i) {
+        multiply(plan, a[i], b[i], mult[i]);
+    });
+}
+
+// Одно большое преобразование на нескольких потоках, шестишаговая схема. Вектор длины n = rows * columns
+// - матрица rows x columns (x[columns * r + c]), и
+// X[k1 + rows * k2] = sum_c w_n^(c k1) w_columns^(c k2) sum_r x[columns * r + c] w_rows^(r k1):
+// 1) транспонирование, 2) columns преобразований строк длины rows, 3) умножение на w_n^(c k1),
+// 4) транспонирование, 5) rows преобразований длины columns, 6) транспонирование в порядок k2, k1.
+// Транспонирования не делаются отдельно: поток берет TILE столбцов, собирает их в свой буфер,
+// преобразует и пишет на место, так что вся схема - два прохода по памяти. Полоски раздаются потокам.
+// w_n^j = high[j / step] * low[j % step] по двум таблицам длины sqrt(n): точно и без таблицы на n
+class ParallelFFT {
+    enum { TILE = 32 };
+
+    size_t size_;
+    size_t rows, columns;
+    size_t threadsNumber;
+    FFTPlan rowPlan, columnPlan;
+    // step = 2^stepLog
+    size_t step, stepLog;
+    std::vector< double > highRe, highIm, lowRe, lowIm;
+
+    void transform(std::vector< double > &re, std::vector< double > &im) const {
+        // промежуточная матрица columns x rows: other[c][k1]
+        std::vector< double > otherRe(size_), otherIm(size_);
+        // 1-3: TILE столбцов x сразу: чтение по строкам x идет кусками подряд, запись - строками other
+        parallelFor((columns + TILE - 1) / TILE, threadsNumber, [&](size_t tile) {
+            size_t first = tile * TILE, count = std::min((size_t) TILE, columns - first);
+            std::vector< double > bufferRe(count * rows), bufferIm(count * rows);
+            for (size_t r = 0; r < rows; r++)
+                for (size_t t = 0; t < count; t++) {
+                    bufferRe[t * rows + r] = re[r * columns + first + t];
+                    bufferIm[t * rows + r] = im[r * columns + first + t];
+                }
+            for (size_t t = 0; t < count; t++) {
+                double *rowRe = &bufferRe[t * rows], *rowIm = &bufferIm[t * rows];
+                rowPlan.forward(rowRe, rowIm);
+                // поворот на w_n^(c k1)
+                size_t c = first + t;
+                for (size_t k = 1; k < rows; k++) {
+                    size_t high = (c * k) >> stepLog, low = (c * k) & (step - 1);
+                    double wRe = highRe[high] * lowRe[low] - highIm[high] * lowIm[low];
+                    double wIm = highRe[high] * lowIm[low] + highIm[high] * lowRe[low];
+                    double valueRe = rowRe[k];
+                    rowRe[k] = valueRe * wRe - rowIm[k] * wIm;
+                    rowIm[k] = valueRe * wIm + rowIm[k] * wRe;
+                }
+                std::copy(rowRe, rowRe + rows, &otherRe[c * rows]);
+                std::copy(rowIm, rowIm + rows, &otherIm[c * rows]);
+            }
+        });
+        // 4-6: TILE столбцов other сразу, результат X[k1 + rows * k2] пишется кусками подряд
+        parallelFor((rows + TILE - 1) / TILE, threadsNumber, [&](size_t tile) {
+            size_t first = tile * TILE, count = std::min((size_t) TILE, rows - first);
+            std::vector< double > bufferRe(count * columns), bufferIm(count * columns);
+            for (size_t c = 0; c < columns; c++)
+                for (size_t t = 0; t < count; t++) {
+                    bufferRe[t * columns + c] = otherRe[c * rows + first + t];
+                    bufferIm[t * columns + c] = otherIm[c * rows + first + t];
+                }
+            for (size_t t = 0; t < count; t++)
+                columnPlan.forward(&bufferRe[t * columns], &bufferIm[t * columns]);
+            for (size_t k = 0; k < columns; k++)
+                for (size_t t = 0; t < count; t++) {
+                    re[k * rows + first + t] = bufferRe[t * columns + k];
+                    im[k * rows + first + t] = bufferIm[t * columns + k];
+                }
+        });
+    }
+
+    static size_t rowsFor(size_t size) {
+        size_t logSize = 0;
+        while ((1UL << logSize) < size)
+            logSize++;
+        return 1UL << ((logSize + 1) / 2);
+    }
+
+public:
+    explicit ParallelFFT(size_t size, size_t threadsNumber = std::thread::hardware_concurrency()):
+        size_(size),
+        rows(rowsFor(size)),
+        columns(std::max(size / rows, (size_t) 1)),
+        threadsNumber(threadsNumber),
+        rowPlan(rows),
+        columnPlan(columns),
+        step(rows),
+        stepLog(0) {
+        while ((1UL << stepLog) < step)
+            stepLog++;
+        size_t highSize = (size + step - 1) / step;
+        highRe.resize(highSize);
+        highIm.resize(highSize);
+        lowRe.resize(step);
+        lowIm.resize(step);
+        for (size_t i = 0; i < highSize; i++) {
+            highRe[i] = cos(2 * M_PI * i * step / size);
+            highIm[i] = sin(2 * M_PI * i * step / size);
+        }
+        for (size_t i = 0; i < step; i++) {
+            lowRe[i] = cos(2 * M_PI * i / size);
+            lowIm[i] = sin(2 * M_PI * i / size);
+        }
+    }
+
+    size_t size() const {
+        return size_;
+    }
+
+    // как FFTPlan::forward: результат в естественном порядке
+    void forward(std::vector< double > &re, std::vector< double > &im) const {
+        if (size_ > 1)
+            transform(re, im);
+    }
+
+    // обратное через прямое: conj(DFT(conj(x))) / n
+    void inverse(std::vector< double > &re, std::vector< double > &im) const {
+        if (size_ <= 1)
+            return;
+        for (size_t i = 0; i < size_; i++)
+            im[i] = -im[i];
+        transform(re, im);
+        for (size_t i = 0; i < size_; i++) {
+            re[i] /= size_;
+            im[i] = -im[i] / size_;
+        }
+    }
+};
+
+// multiplyRealPairs на ParallelFFT: образы в естественном порядке, частота n - k лежит на месте n - k
+void multiplyRealPairs(const ParallelFFT &plan, std::vector< double > &firstRe, std::vector< double > &firstIm,
+                       std::vector< double > &secondRe, std::vector< double > &secondIm) {
+    size_t n = plan.size();
+    plan.forward(firstRe, firstIm);
+    plan.forward(secondRe, secondIm);
+    for (size_t p = 0; p < n; p++) {
+        size_t q = (n - p) & (n - 1);
+        if (q >= p)
+            combineRealPairs(firstRe, firstIm, secondRe, secondIm, p, q);
+    }
+    plan.inverse(firstRe, firstIm);
+}
+
+#endif
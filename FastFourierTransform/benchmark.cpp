@@ -0,0 +1,299 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <complex>
+#include <cmath>
+#include <cstdlib>
+#include <chrono>
+
+#include "FFT.hpp"
+#include "NTT.hpp"
+#include "ParallelFFT.hpp"
+
+// точность и скорость FFT по размерам 2^4..2^maxLog (нужны -std=c++11 -pthread)
+// usage: benchmark [maxLog] [csv|json], maxLog не больше 26
+
+typedef std::complex< long double > Reference;
+
+// эталон: то же БПФ в long double, корни берутся прямо из cosl и sinl
+void referenceDFT(std::vector< Reference > &v) {
+    size_t n = v.size();
+    for (size_t i = 1, j = 0; i < n; i++) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1)
+            j ^= bit;
+        j ^= bit;
+        if (i < j)
+            std::swap(v[i], v[j]);
+    }
+    for (size_t length = 2; length <= n; length *= 2) {
+        std::vector< Reference > roots(length / 2);
+        for (size_t j = 0; j < length / 2; j++) {
+            long double angle = 2 * acosl(-1) * j / length;
+            roots[j] = Reference(cosl(angle), sinl(angle));
+        }
+        for (size_t i = 0; i < n; i += length)
+            for (size_t j = 0; j < length / 2; j++) {
+                Reference left = v[i + j], right = v[i + length / 2 + j] * roots[j];
+                v[i + j] = left + right;
+                v[i + length / 2 + j] = left - right;
+            }
+    }
+}
+
+// определение за O(n^2), для проверки самого эталона на малых размерах
+void naiveDFT(std::vector< Reference > &v) {
+    size_t n = v.size();
+    std::vector< Reference > result(n);
+    for (size_t k = 0; k < n; k++)
+        for (size_t j = 0; j < n; j++) {
+            long double angle = 2 * acosl(-1) * (j * k % n) / n;
+            result[k] += v[j] * Reference(cosl(angle), sinl(angle));
+        }
+    v.swap(result);
+}
+
+struct Result {
+    size_t size;
+    std::string operation;
+    double seconds;      // на одну операцию
+    double maxError;     // max |ошибка| / max |эталон|
+    double rmsError;     // sqrt(sum ошибка^2 / sum эталон^2)
+    bool ok;
+};
+
+// Время одной операции по настенным часам: clock считал бы процессорное время всех потоков вместе,
+// и ParallelFFT никогда не показал бы ускорения. Операции портят свой вход, поэтому он восстанавливается
+// перед каждым повтором, но вне замера: prepare(i) готовит i-й из copies входов, operation(i) работает с ним.
+// Входов столько, чтобы замеряемая пачка не была слишком короткой, а все копии вместе лежали в кэше.
+// Повторяем, пока замеренное время не наберет 0.1 секунды
+template < class Prepare, class Operation >
+double measure(size_t copies, Prepare prepare, Operation operation) {
+    typedef std::chrono::steady_clock Clock;
+    size_t repeats = 0;
+    Clock::duration total(0);
+    do {
+        for (size_t i = 0; i < copies; i++)
+            prepare(i);
+        Clock::time_point begin = Clock::now();
+        for (size_t i = 0; i < copies; i++)
+            operation(i);
+        total += Clock::now() - begin;
+        repeats += copies;
+    } while (total < std::chrono::milliseconds(100));
+    return std::chrono::duration< double >(total).count() / repeats;
+}
+
+// сколько копий входа в bytes байт держать для measure: вместе около мегабайта, хотя бы одна
+size_t copiesFor(size_t bytes) {
+    return std::max((size_t) 1, (size_t) (1 << 20) / bytes);
+}
+
+template < class Value >
+void compare(const std::vector< Value > &values, const std::vector< Reference > &reference, Result &result) {
+    long double maxError = 0, maxReference = 0, sumError = 0, sumReference = 0;
+    for (size_t i = 0; i < reference.size(); i++) {
+        Reference value(values[i].real(), values[i].imag());
+        long double error = std::abs(value - reference[i]);
+        maxError = std::max(maxError, error);
+        maxReference = std::max(maxReference, std::abs(reference[i]));
+        sumError += error * error;
+        sumReference += std::norm(reference[i]);
+    }
+    result.maxError = maxReference > 0 ? maxError / maxReference : maxError;
+    result.rmsError = sumReference > 0 ? sqrtl(sumError / sumReference) : sqrtl(sumError);
+}
+
+void benchmark(size_t logSize, std::vector< Result > &results) {
+    size_t n = 1UL << logSize;
+    Result result;
+    result.size = n;
+    std::vector< Base > signal(n);
+    std::vector< Reference > reference(n);
+    for (size_t i = 0; i < n; i++) {
+        signal[i] = Base(rand() / (RAND_MAX + 1.) - .5, rand() / (RAND_MAX + 1.) - .5);
+        reference[i] = Reference(signal[i].real(), signal[i].imag());
+    }
+    std::vector< Reference > expected = reference;
+    referenceDFT(expected);
+
+    // сам эталон против определения
+    if (n <= 1024) {
+        std::vector< Reference > naive = reference;
+        naiveDFT(naive);
+        result.operation = "reference-vs-naive";
+        result.seconds = 0;
+        compare(expected, naive, result);
+        result.ok = result.rmsError < 1e-15;
+        results.push_back(result);
+    }
+
+    // замеряются ровно DFT и inverseDFT, на которых считается точность
+    size_t copies = copiesFor(n * sizeof(Base));
+    std::vector< std::vector< Base > > inputs(copies);
+    result.operation = "DFT";
+    std::vector< Base > transformed = signal;
+    DFT(transformed);
+    compare(transformed, expected, result);
+    // вход восстанавливается на каждом повторе: иначе значения растут до переполнения,
+    // а после обратного преобразования уходят в денормализованные числа
+    result.seconds = measure(copies, [&](size_t i) {
+        inputs[i] = signal;
+    }, [&](size_t i) {
+        DFT(inputs[i]);
+    });
+    // ошибка двойной точности растет как log n, запас на порядок
+    result.ok = result.rmsError < 1e-15 * (logSize + 10);
+    results.push_back(result);
+
+    result.operation = "inverseDFT";
+    std::vector< Base > spectrum = transformed;
+    inverseDFT(transformed);
+    compare(transformed, reference, result);
+    result.seconds = measure(copies, [&](size_t i) {
+        inputs[i] = spectrum;
+    }, [&](size_t i) {
+        inverseDFT(inputs[i]);
+    });
+    result.ok = result.rmsError < 1e-15 * (logSize + 10);
+    results.push_back(result);
+    std::vector< std::vector< Base > >().swap(inputs);
+
+    // то же одно преобразование, поделенное между потоками шестишаговой схемой
+    ParallelFFT parallel(n);
+    std::vector< double > signalRe(n), signalIm(n);
+    for (size_t i = 0; i < n; i++) {
+        signalRe[i] = signal[i].real();
+        signalIm[i] = signal[i].imag();
+    }
+    std::vector< double > re = signalRe, im = signalIm;
+    copies = copiesFor(2 * n * sizeof(double));
+    std::vector< std::vector< double > > inputsRe(copies), inputsIm(copies);
+    result.operation = "parallel-DFT";
+    parallel.forward(re, im);
+    for (size_t i = 0; i < n; i++)
+        transformed[i] = Base(re[i], im[i]);
+    compare(transformed, expected, result);
+    result.seconds = measure(copies, [&](size_t i) {
+        inputsRe[i] = signalRe;
+        inputsIm[i] = signalIm;
+    }, [&](size_t i) {
+        parallel.forward(inputsRe[i], inputsIm[i]);
+    });
+    result.ok = result.rmsError < 1e-15 * (logSize + 10);
+    results.push_back(result);
+
+    result.operation = "parallel-inverseDFT";
+    std::vector< double > spectrumRe = re, spectrumIm = im;
+    parallel.inverse(re, im);
+    for (size_t i = 0; i < n; i++)
+        transformed[i] = Base(re[i], im[i]);
+    compare(transformed, reference, result);
+    result.seconds = measure(copies, [&](size_t i) {
+        inputsRe[i] = spectrumRe;
+        inputsIm[i] = spectrumIm;
+    }, [&](size_t i) {
+        parallel.inverse(inputsRe[i], inputsIm[i]);
+    });
+    result.ok = result.rmsError < 1e-15 * (logSize + 10);
+    results.push_back(result);
+    std::vector< std::vector< double > >().swap(inputsRe);
+    std::vector< std::vector< double > >().swap(inputsIm);
+
+    // свертка целых до 2^10 против точной на NTT; округленный результат обязан совпасть.
+    // На самых длинных размерах модулей NTT не хватает, там свертки не сравниваются
+    std::vector< unsigned int > a(n / 2), b(n / 2);
+    for (size_t i = 0; i < n / 2; i++) {
+        a[i] = rand() % 1024;
+        b[i] = rand() % 1024;
+    }
+    std::vector< unsigned long long > exact;
+    if (!multiply(a, b, exact))
+        return;
+    std::vector< Base > first(n), second(n), product(n);
+    for (size_t i = 0; i < n / 2; i++) {
+        first[i] = a[i];
+        second[i] = b[i];
+    }
+    FFTPlan plan(n);
+    std::vector< Base > firstCopy = first, secondCopy = second;
+    multiply(plan, firstCopy, secondCopy, product);
+    std::vector< Reference > exactProduct(n);
+    for (size_t i = 0; i < exact.size(); i++)
+        exactProduct[i] = exact[i];
+    result.operation = "multiply";
+    compare(product, exactProduct, result);
+    result.ok = true;
+    for (size_t i = 0; i < n; i++)
+        result.ok = result.ok && std::abs(product[i].real() - exactProduct[i].real()) < .5;
+    // multiply портит оба входа
+    copies = copiesFor(2 * n * sizeof(Base));
+    std::vector< std::vector< Base > > firstInputs(copies), secondInputs(copies);
+    result.seconds = measure(copies, [&](size_t i) {
+        firstInputs[i] = first;
+        secondInputs[i] = second;
+    }, [&](size_t i) {
+        multiply(plan, firstInputs[i], secondInputs[i], product);
+    });
+    results.push_back(result);
+
+    result.operation = "multiply-ntt";
+    result.maxError = result.rmsError = 0;
+    result.ok = true;
+    result.seconds = measure(1, [](size_t) {
+    }, [&](size_t) {
+        multiply(a, b, exact);
+    });
+    results.push_back(result);
+}
+
+// бабочек в преобразовании n / 2 * log n, операций с плавающей точкой по общепринятой оценке 5 n log n
+double butterflies(size_t size) {
+    return size / 2. * log2(size);
+}
+
+void printCSV(const std::vector< Result > &results) {
+    std::cout << "size,operation,seconds,nsPerButterfly,gflops,maxError,rmsError,ok" << std::endl;
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result &result = results[i];
+        std::cout << result.size << ',' << result.operation << ',' << result.seconds << ','
+            << result.seconds * 1e9 / butterflies(result.size) << ','
+            << (result.seconds > 0 ? 10 * butterflies(result.size) / result.seconds / 1e9 : 0) << ','
+            << result.maxError << ',' << result.rmsError << ',' << (result.ok ? "yes" : "no") << std::endl;
+    }
+}
+
+void printJSON(const std::vector< Result > &results) {
+    std::cout << '[' << std::endl;
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result &result = results[i];
+        std::cout << "  {\"size\": " << result.size << ", \"operation\": \"" << result.operation
+            << "\", \"seconds\": " << result.seconds
+            << ", \"nsPerButterfly\": " << result.seconds * 1e9 / butterflies(result.size)
+            << ", \"gflops\": " << (result.seconds > 0 ? 10 * butterflies(result.size) / result.seconds / 1e9 : 0)
+            << ", \"maxError\": " << result.maxError << ", \"rmsError\": " << result.rmsError
+            << ", \"ok\": " << (result.ok ? "true" : "false") << '}' << (i + 1 < results.size() ? "," : "")
+            << std::endl;
+    }
+    std::cout << ']' << std::endl;
+}
+
+int main(int argc, char **argv) {
+    // больше 2^26 не бывает ни эталона в памяти, ни точной свертки на NTT
+    size_t maxLog = std::min(argc > 1 ? (size_t) atol(argv[1]) : 22, (size_t) 26);
+    std::string format = argc > 2 ? argv[2] : "csv";
+    srand(1);
+    std::vector< Result > results;
+    // эталон в long double на 2^26 занимает несколько гигабайт, поэтому по умолчанию 2^22
+    for (size_t logSize = 4; logSize <= maxLog; logSize++)
+        benchmark(logSize, results);
+    if (format == "json")
+        printJSON(results);
+    else
+        printCSV(results);
+    bool ok = true;
+    for (size_t i = 0; i < results.size(); i++)
+        ok = ok && results[i].ok;
+    return !ok;
+}
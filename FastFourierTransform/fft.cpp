@@ -1,109 +1,140 @@
-#define _USE_MATH_DEFINES
-
-#include <complex>
 #include <iostream>
 #include <vector>
+#include <string>
 #include <cstdio>
-#include <cmath>
-
-typedef std::complex< double > Base;
-
-size_t reverseBits(size_t value, size_t logSize) {
-    size_t result = 0;
-    for (size_t i = 0; i < logSize; i++)
-        result |= (((1UL << i) & value) >> i) << (logSize - i - 1);
-    return result;
-}
-
-//       
-void reverseVector(std::vector< Base > &v) {
-    size_t logSize = 0;
-    while ((1UL << logSize) < v.size())
-        logSize++;
-    for (size_t i = 0; i < v.size(); i++) {
-        size_t j = reverseBits(i, logSize);
-        if (i < j)
-            std::swap(v[i], v[j]);
-    }
-}
 
+#include "FFT.hpp"
+#include "NTT.hpp"
+#include "Mismatches.hpp"
+#include "OverlapSave.hpp"
+#include "ParallelFFT.hpp"
 
-//   1
-void calcRoots(std::vector< Base > &roots, bool inverse) {
-    double angle = 2 * M_PI / roots.size() * (inverse ? -1 : 1);
-    Base mainRoot(cos(angle), sin(angle));
-    roots[0] = Base(1, 0);
-    for (size_t i = 1; i < roots.size(); i++)
-        roots[i] = roots[i - 1] * mainRoot;
-}
-
-void fft(std::vector < Base > &v, std::vector < Base > &roots) {
-    reverseVector(v);
-    for (size_t length = 2; length <= v.size(); length *= 2) {
-        for (size_t i = 0; i < v.size() / length; i++) {
-            for (size_t j = 0; j < length / 2; j++) {
-                Base left = v[i * length + j];
-                Base right = v[i * length + length / 2 + j] * roots[v.size() / length * j];
-                v[i * length + j] = left + right;
-                v[i * length + length / 2 + j] = left - right;
-            }
-        }
-    }
-}
-
-void DFT(std::vector< Base > &v) {
-    std::vector< Base > roots(v.size());
-    calcRoots(roots, false);
-    fft(v, roots);
-}
-
-void inverseDFT(std::vector< Base > &v) {
-    std::vector< Base > roots(v.size());
-    calcRoots(roots, true);
-    fft(v, roots);
-    for (size_t i = 0; i < v.size(); i++)
-        v[i] /= v.size();
-}
-
-void multiply(std::vector< Base > &a, std::vector< Base > &b, std::vector< Base > &mult) {
-    DFT(a);
-    DFT(b);
-    for (size_t i = 0; i < a.size(); i++)
-        mult[i] = a[i] * b[i];
-    inverseDFT(mult);
-}
-
-size_t solve(const std::string &a, const std::string &b) {
+// наибольшее число совпадений b с циклическими сдвигами a на БПФ в double; ответ округляется,
+// поэтому на очень длинных строках может ошибиться. Plan - FFTPlan или ParallelFFT, на котором
+// преобразование большого размера делится между потоками
+template < class Plan >
+size_t solveFloat(const std::string &a, const std::string &b) {
     size_t size = a.size() * 2;
     size_t n = 1;
-    //     2-  
+    //округлим длину вверх до степени 2-и и удвоим
     while (n < 2 * size)
         n *= 2;
-    std::vector< Base > first(n), second(n);
-    std::vector< Base > firstInv(n), secondInv(n);
-    std::vector< Base > mult(n), multInv(n);
-    //   0-1 
+    // first - слово a (действительная часть) и его инверсия (мнимая), second - то же для b.
+    // Обе корреляции считаются одной парной сверткой
+    std::vector< double > firstRe(n), firstIm(n), secondRe(n), secondIm(n);
+    //переведем строки в 0-1 слова
     for (size_t i = 0; i < a.size(); i++) {
-        first[i].real(a[i] - 'a');
-        first[i + a.size()].real(a[i] - 'a');
-        firstInv[i].real(1 - (a[i] - 'a'));
-        firstInv[i + a.size()].real(1 - (a[i] - 'a'));
+        firstRe[i] = firstRe[i + a.size()] = a[i] - 'a';
+        firstIm[i] = firstIm[i + a.size()] = 1 - (a[i] - 'a');
+    }
+    for (size_t i = 0; i < b.size(); i++) {
+        secondRe[b.size() - i - 1] = b[i] - 'a';
+        secondIm[b.size() - i - 1] = 1 - (b[i] - 'a');
+    }
+    Plan plan(n);
+    multiplyRealPairs(plan, firstRe, firstIm, secondRe, secondIm);
+    size_t maxLength = 0;
+    for (size_t i = a.size(); i < n; i++)
+        maxLength = std::max(maxLength, (size_t)(firstRe[i] + .5) + (size_t)(firstIm[i] + .5));
+    return maxLength;
+}
+
+// то же точно через NTT и одной сверткой: совпадения букв 'b' дает свертка, а совпадения букв 'a'
+// в окне - это длина окна минус единицы a в нем минус единицы b плюс совпадения единиц.
+// Свертки длиннее NTT_MAX_SIZE точно не считаются, для них остается solveFloat
+size_t solve(const std::string &a, const std::string &b) {
+    // text - a дважды, pattern - b задом наперед
+    std::vector< unsigned int > text(2 * a.size()), pattern(b.size());
+    // textOnes, patternOnes - префиксные суммы единиц
+    std::vector< size_t > textOnes(text.size() + 1, 0), patternOnes(b.size() + 1, 0);
+    for (size_t i = 0; i < text.size(); i++) {
+        text[i] = a[i % a.size()] - 'a';
+        textOnes[i + 1] = textOnes[i] + text[i];
     }
     for (size_t i = 0; i < b.size(); i++) {
-        second[b.size() - i - 1].real(b[i] - 'a');
-        secondInv[b.size() - i - 1].real(1 - (b[i] - 'a'));
+        pattern[b.size() - i - 1] = b[i] - 'a';
+        patternOnes[i + 1] = patternOnes[i] + (b[i] - 'a');
     }
-    multiply(first, second, mult);
-    multiply(firstInv, secondInv, multInv);
+    std::vector< unsigned long long > ones;
+    if (!multiply(text, pattern, ones))
+        return solveFloat< FFTPlan >(a, b);
     size_t maxLength = 0;
-    for (size_t i = a.size(); i < mult.size(); i++)
-        maxLength = std::max(maxLength, (size_t)(mult[i].real() + .5) + (size_t)(multInv[i].real() + .5));
+    for (size_t i = a.size(); i < ones.size(); i++) {
+        // окно text[start..start + b.size()) против b, от него остается часть внутри text
+        long long start = (long long) i - (long long) b.size() + 1;
+        long long begin = std::max(0LL, -start);
+        long long end = std::min((long long) b.size(), (long long) text.size() - start);
+        if (end <= begin)
+            continue;
+        size_t zeros = (end - begin) - (textOnes[start + end] - textOnes[start + begin])
+            - (patternOnes[end] - patternOnes[begin]) + ones[i];
+        maxLength = std::max(maxLength, (size_t) ones[i] + zeros);
+    }
     return maxLength;
 }
 
-int main() {
+// наименьшее число несовпадений образца b с окнами потока, читаемого до конца ввода,
+// и начало первого такого окна. Буквы переводятся в -1 и 1, тогда несовпадения окна - (m - корреляция) / 2
+void solveStream(const std::string &b, std::istream &in) {
+    std::vector< double > pattern(b.size());
+    for (size_t i = 0; i < b.size(); i++)
+        pattern[i] = b[i] == 'a' ? -1 : 1;
+    OverlapSave correlation(pattern);
+    std::vector< double > samples, scores;
+    size_t best = b.size() + 1, bestOffset = 0, offset = 0;
+    std::vector< char > chunk(1 << 16);
+    while (in) {
+        in.read(&chunk[0], chunk.size());
+        samples.clear();
+        for (std::streamsize i = 0; i < in.gcount(); i++)
+            if (chunk[i] == 'a' || chunk[i] == 'b')
+                samples.push_back(chunk[i] == 'a' ? -1 : 1);
+        scores.clear();
+        correlation.push(samples.empty() ? NULL : &samples[0], samples.size(), scores);
+        if (!in)
+            correlation.flush(scores);
+        for (size_t i = 0; i < scores.size(); i++, offset++) {
+            size_t mismatches = (size_t) ((b.size() - scores[i]) / 2 + .5);
+            if (mismatches < best) {
+                best = mismatches;
+                bestOffset = offset;
+            }
+        }
+    }
+    if (best > b.size())
+        std::cout << -1 << std::endl;
+    else
+        std::cout << best << ' ' << bestOffset << std::endl;
+}
+
+// fft [float]                 - по умолчанию точный подсчет, float - прежний на БПФ в double
+// fft parallel                - как float, но БПФ на всех ядрах (ParallelFFT)
+// fft stream                  - образец, затем поток до конца ввода; наименьшее число несовпадений
+//                                с окном потока и начало окна
+// fft mismatches [wildcard]   - текст и образец; несовпадения образца с каждой позицией текста,
+//                                символ wildcard совпадает с любым
+int main(int argc, char **argv) {
     //freopen("input.in", "r", stdin);
     std::string a, b;
+    if (argc > 1 && std::string(argv[1]) == "stream") {
+        std::cin >> b;
+        solveStream(b, std::cin);
+        return 0;
+    }
     std::cin >> a >> b;
-    std::cout << a.size() - solve(a, b) << std::endl;
+    if (argc > 1 && std::string(argv[1]) == "mismatches") {
+        std::vector< size_t > mismatches;
+        if (!countMismatches(a, b, mismatches, argc > 2 ? (unsigned char) argv[2][0] : -1)) {
+            std::cerr << "pattern is too long" << std::endl;
+            return 1;
+        }
+        for (size_t i = 0; i < mismatches.size(); i++)
+            std::cout << mismatches[i] << (i + 1 < mismatches.size() ? " " : "");
+        std::cout << std::endl;
+    } else if (argc > 1 && std::string(argv[1]) == "float")
+        std::cout << a.size() - solveFloat< FFTPlan >(a, b) << std::endl;
+    else if (argc > 1 && std::string(argv[1]) == "parallel")
+        std::cout << a.size() - solveFloat< ParallelFFT >(a, b) << std::endl;
+    else
+        std::cout << a.size() - solve(a, b) << std::endl;
 }
\ No newline at end of file
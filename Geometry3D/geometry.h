@@ -6,17 +6,27 @@
 #include <algorithm>
 #include <map>
 #include <queue>
+#include <random>
+
+#include "predicates.h"
 
 namespace geometry {
 
+    // С -DDOUBLE_POINTS координаты хранятся в double: вдвое меньше памяти и арифметика SSE вместо x87
+#ifdef DOUBLE_POINTS
+    typedef double Coordinate;
+#else
+    typedef long double Coordinate;
+#endif
+
     struct Point {
-        long double x;
-        long double y;
-        long double z;
+        Coordinate x;
+        Coordinate y;
+        Coordinate z;
         Point() {
-            x = y = z = std::numeric_limits< long double >::quiet_NaN();
+            x = y = z = std::numeric_limits< Coordinate >::quiet_NaN();
         }
-        Point(long double x, long double y, long double z): x(x), y(y), z(z) {}
+        Point(Coordinate x, Coordinate y, Coordinate z): x(x), y(y), z(z) {}
 
         Point operator+(const Point &point) const {
             return Point(x + point.x, y + point.y, z + point.z);
@@ -24,23 +34,23 @@ namespace geometry {
         Point operator-(const Point &point) const {
             return Point(x - point.x, y - point.y, z - point.z);
         }
-        long double operator*(const Point &point) const {
+        Coordinate operator*(const Point &point) const {
             return x * point.x + y * point.y + z * point.z;
         }
         Point operator^(const Point &point) const {
             return Point(y * point.z - z * point.y, z * point.x - x * point.z, x * point.y - y * point.x);
         }
 
-        Point operator*(long double value) const {
+        Point operator*(Coordinate value) const {
             return Point(x * value, y * value, z * value);
         }
-        Point operator/(long double value) const {
+        Point operator/(Coordinate value) const {
             return Point(x / value, y / value, z / value);
         }
-        Point operator+(long double value) const {
+        Point operator+(Coordinate value) const {
             return Point(x + value, y + value, z + value);
         }
-        Point operator-(long double value) const {
+        Point operator-(Coordinate value) const {
             return Point(x - value, y - value, z - value);
         }
 
@@ -55,11 +65,11 @@ namespace geometry {
                 || (x == point.x && y == point.y && z < point.z);
         }
 
-        long double sqrLength() {
+        Coordinate sqrLength() {
             return (*this) * (*this);
         }
-        long double length() {
-            return sqrtl(sqrLength());
+        Coordinate length() {
+            return std::sqrt(sqrLength());
         }
         
         friend std::istream &operator>>(std::istream &in, Point &point);
@@ -78,10 +88,10 @@ namespace geometry {
         Point a;
         Point b;
         Segment(const Point &a, const Point &b): a(a), b(b) {}
-        long double sqrLength() {
+        Coordinate sqrLength() {
             return (a - b).sqrLength();
         }
-        long double length() {
+        Coordinate length() {
             return (a - b).length();
         }
     };
@@ -95,12 +105,12 @@ namespace geometry {
         }
     };
 
-    //  .      
+    // ориентированная плоскость. верхняя сторона вычисляется по правилу буравчика
     struct Plane {
         Point point;
         Point firstDirection;
         Point secondDirection;
-        //     
+        // все еще работает правило буравчика
         Plane(const Point &a, const Point &b, const Point &c) {
             point = a;
             firstDirection = b - a;
@@ -109,8 +119,8 @@ namespace geometry {
         Point normal() const {
             return firstDirection ^ secondDirection;
         }
-        //    
-        long double distanse(const Point &p) {
+        //измеряется в длинах вектора нормали
+        Coordinate distanse(const Point &p) {
             Point norm = normal();
             return (norm * (p - point)) / (norm * norm); 
         }
@@ -119,111 +129,208 @@ namespace geometry {
         }
     };
 
+    // ориентация точки d относительно плоскости (a, b, c): положительна, если d с той стороны,
+    // куда смотрит нормаль (b - a) ^ (c - a), то есть как в Plane::distanse, но без деления.
+    // Знак точный для координат, представимых в double; long double округляется до double
+    double orientation(const Point &a, const Point &b, const Point &c, const Point &d) {
+        double first[3] = {(double) a.x, (double) a.y, (double) a.z};
+        double second[3] = {(double) b.x, (double) b.y, (double) b.z};
+        double third[3] = {(double) c.x, (double) c.y, (double) c.z};
+        double fourth[3] = {(double) d.x, (double) d.y, (double) d.z};
+        return predicates::orient3d(first, second, third, fourth);
+    }
+
+    // положительна, если e внутри сферы через a, b, c, d при orientation(a, b, c, d) > 0
+    double insphere(const Point &a, const Point &b, const Point &c, const Point &d, const Point &e) {
+        double first[3] = {(double) a.x, (double) a.y, (double) a.z};
+        double second[3] = {(double) b.x, (double) b.y, (double) b.z};
+        double third[3] = {(double) c.x, (double) c.y, (double) c.z};
+        double fourth[3] = {(double) d.x, (double) d.y, (double) d.z};
+        double fifth[3] = {(double) e.x, (double) e.y, (double) e.z};
+        return predicates::insphere(first, second, third, fourth, fifth);
+    }
+
     struct SetOfPoints {
         std::vector< Point > points;
     private:
-        //   (first, second)   normal         
-        //       opened     
-        void addSegment(std::map< std::pair< size_t, size_t >, Point > &segments,
-                        std::queue< std::pair< size_t, size_t > > &opened,
-                        size_t first, size_t second, const Point &normal) {
-            segments[std::make_pair(first, second)] = Point(0, 0, 0);
-            std::pair < size_t, size_t > segment(second, first);
-            if (segments.find(segment) == segments.end()) {
-                segments[segment] = normal;
-                opened.push(segment);
-            }
+        // грань оболочки, вершины против часовой стрелки, если смотреть снаружи.
+        // neighbors[i] - грань за ребром (vertices[i], vertices[(i + 1) % 3])
+        struct Face {
+            size_t vertices[3];
+            size_t neighbors[3];
+            bool alive;
+            // точка, из которой грань видна на текущем шаге
+            size_t visibleFrom;
+            // еще не добавленные точки строго снаружи плоскости грани
+            std::vector< size_t > conflicts;
+        };
+
+        // граф конфликтов: грани со списками видящих их точек и, наоборот, для каждой точки видимые ей грани.
+        // у точек удаленные грани не вычищаются сразу, а пропускаются при чтении
+        struct Hull {
+            std::vector< Face > faces;
+            std::vector< std::vector< size_t > > pointConflicts;
+        };
+
+        size_t addFace(Hull &hull, size_t a, size_t b, size_t c) const {
+            Face face;
+            face.vertices[0] = a;
+            face.vertices[1] = b;
+            face.vertices[2] = c;
+            face.neighbors[0] = face.neighbors[1] = face.neighbors[2] = -1;
+            face.alive = true;
+            face.visibleFrom = -1;
+            hull.faces.push_back(face);
+            return hull.faces.size() - 1;
         }
 
-        //   (first, scond, bottom)  
-        //     
-        std::vector< size_t > addPlane(std::map< std::pair< size_t, size_t >, Point > &segments,
-                                       std::queue< std::pair< size_t, size_t > > &opened,
-                                       size_t bottom, size_t first, size_t second) {
-            Point normal = Plane(points[bottom], points[first], points[second]).normal();
-            addSegment(segments, opened, bottom, first, normal);
-            addSegment(segments, opened, first, second, normal);
-            addSegment(segments, opened, second, bottom, normal);
-            std::vector< size_t > plane;
-            plane.push_back(bottom);
-            plane.push_back(first);
-            plane.push_back(second);
-            return plane;
-        }
-
-        // -    
-        std::vector< size_t > initConvexHull(std::map< std::pair< size_t, size_t >, Point > &segments,
-                                             std::queue< std::pair< size_t, size_t > > &opened) {
-            //     
-            size_t bottom = 0;
+        void addConflict(Hull &hull, size_t face, size_t point) const {
+            hull.faces[face].conflicts.push_back(point);
+            hull.pointConflicts[point].push_back(face);
+        }
+
+        bool sees(const Hull &hull, size_t point, size_t face) const {
+            const size_t *vertices = hull.faces[face].vertices;
+            return orientation(points[vertices[0]], points[vertices[1]], points[vertices[2]], points[point]) > 0;
+        }
+
+        //найдем 4 точки не в одной плоскости, каждую следующую как можно дальше от предыдущих
+        bool initSimplex(size_t simplex[4]) const {
+            simplex[0] = 0;
             for (size_t i = 1; i < points.size(); i++)
-                if (points[i].z < points[bottom].z)
-                    bottom = i;
-            //      Oz
-            size_t second = bottom;
-            long double maxSqrSin = 0;
+                if (points[i] < points[simplex[0]])
+                    simplex[0] = i;
+            Coordinate best[3] = {0, 0, 0};
             for (size_t i = 0; i < points.size(); i++) {
-                if (i != bottom) {
-                    Point vect = points[i] - points[bottom];
-                    //  sin^2  .     0  pi/2
-                    long double sqrSin = (vect ^ Point(0, 0, 1)).sqrLength() / vect.sqrLength();
-                    if (sqrSin > maxSqrSin) {
-                        second = i;
-                        maxSqrSin = sqrSin;
-                    }
+                Point vect = points[i] - points[simplex[0]];
+                Coordinate sqrLength = vect * vect;
+                if (sqrLength > best[0]) {
+                    best[0] = sqrLength;
+                    simplex[1] = i;
+                }
+            }
+            if (best[0] == 0)
+                return false;
+            for (size_t i = 0; i < points.size(); i++) {
+                Point norm = (points[simplex[1]] - points[simplex[0]]) ^ (points[i] - points[simplex[0]]);
+                Coordinate sqrArea = norm * norm;
+                if (sqrArea > best[1]) {
+                    best[1] = sqrArea;
+                    simplex[2] = i;
                 }
             }
-            size_t first;
-            //  n*n   3- 
-            for (size_t i = 0; i < points.size(); i++) 
-                if (i != bottom && i != second) {
-                    Plane plane(points[bottom], points[i], points[second]);
-                    bool onHull = true;
-                    for (size_t j = 0; j < points.size() && onHull; j++)
-                        //,       1   ,     
-                        if (i != j && second != j && bottom != j && plane.distanse(points[j]) > 0)
-                            onHull = false;
-                    if (onHull) {
-                        first = i;
-                        break;
+            if (best[1] == 0)
+                return false;
+            for (size_t i = 0; i < points.size(); i++) {
+                double volume = std::fabs(orientation(points[simplex[0]], points[simplex[1]],
+                                                      points[simplex[2]], points[i]));
+                if (volume > best[2]) {
+                    best[2] = volume;
+                    simplex[3] = i;
+                }
+            }
+            return best[2] != 0;
+        }
+
+        //тетраэдр с внешними нормалями и соседями граней
+        void initHull(Hull &hull, size_t simplex[4]) const {
+            if (orientation(points[simplex[0]], points[simplex[1]], points[simplex[2]], points[simplex[3]]) > 0)
+                std::swap(simplex[1], simplex[2]);
+            addFace(hull, simplex[0], simplex[1], simplex[2]);
+            addFace(hull, simplex[0], simplex[3], simplex[1]);
+            addFace(hull, simplex[1], simplex[3], simplex[2]);
+            addFace(hull, simplex[0], simplex[2], simplex[3]);
+            for (size_t f = 0; f < 4; f++)
+                for (size_t i = 0; i < 3; i++)
+                    for (size_t g = 0; g < 4; g++)
+                        for (size_t j = 0; j < 3; j++)
+                            if (hull.faces[f].vertices[i] == hull.faces[g].vertices[(j + 1) % 3]
+                                && hull.faces[f].vertices[(i + 1) % 3] == hull.faces[g].vertices[j])
+                                hull.faces[f].neighbors[i] = g;
+        }
+
+        //добавим точку point: удалим видимые из нее грани и натянем конус на их границу (горизонт).
+        //конфликты новой грани на ребре горизонта ищутся только среди конфликтов двух граней у этого ребра
+        void addPoint(Hull &hull, size_t point, std::vector< size_t > &startsAt, std::vector< size_t > &mark) const {
+            std::vector< size_t > visible;
+            for (size_t i = 0; i < hull.pointConflicts[point].size(); i++) {
+                size_t face = hull.pointConflicts[point][i];
+                if (hull.faces[face].alive) {
+                    hull.faces[face].visibleFrom = point;
+                    visible.push_back(face);
+                }
+            }
+            std::vector< size_t >().swap(hull.pointConflicts[point]);
+            //точка внутри оболочки или на ее границе
+            if (visible.empty())
+                return;
+            std::vector< size_t > created;
+            for (size_t i = 0; i < visible.size(); i++)
+                for (size_t edge = 0; edge < 3; edge++) {
+                    size_t face = visible[i];
+                    size_t other = hull.faces[face].neighbors[edge];
+                    if (hull.faces[other].visibleFrom == point)
+                        continue;
+                    size_t first = hull.faces[face].vertices[edge];
+                    size_t second = hull.faces[face].vertices[(edge + 1) % 3];
+                    size_t added = addFace(hull, first, second, point);
+                    hull.faces[added].neighbors[0] = other;
+                    for (size_t j = 0; j < 3; j++)
+                        if (hull.faces[other].neighbors[j] == face)
+                            hull.faces[other].neighbors[j] = added;
+                    startsAt[first] = added;
+                    created.push_back(added);
+                    for (size_t side = 0; side < 2; side++) {
+                        const std::vector< size_t > &candidates = hull.faces[side ? other : face].conflicts;
+                        for (size_t j = 0; j < candidates.size(); j++) {
+                            size_t candidate = candidates[j];
+                            if (candidate != point && mark[candidate] != added) {
+                                mark[candidate] = added;
+                                if (sees(hull, candidate, added))
+                                    addConflict(hull, added, candidate);
+                            }
+                        }
                     }
                 }
-            return addPlane(segments, opened, bottom, first, second);
+            //горизонт - простой цикл, поэтому соседа за ребром (second, point) находим по вершине second
+            for (size_t i = 0; i < created.size(); i++) {
+                size_t next = startsAt[hull.faces[created[i]].vertices[1]];
+                hull.faces[created[i]].neighbors[1] = next;
+                hull.faces[next].neighbors[2] = created[i];
+            }
+            for (size_t i = 0; i < visible.size(); i++) {
+                hull.faces[visible[i]].alive = false;
+                std::vector< size_t >().swap(hull.faces[visible[i]].conflicts);
+            }
         }
     public:
+        //рандомизированный инкрементный алгоритм с графом конфликтов, в среднем O(n log n).
+        //точки на границе оболочки, но не в ее вершинах, пропускаются; грани в одной плоскости
+        //остаются отдельными треугольниками. если все точки лежат в одной плоскости, граней нет
         void convexHull(std::vector< std::vector< size_t > > &planes) {
             planes.clear();
-            if (points.size() < 3)
+            size_t simplex[4];
+            if (points.size() < 4 || !initSimplex(simplex))
                 return;
-            //              
-            //   1       ,  
-            //     ,   
-            std::map< std::pair< size_t, size_t >, Point > segments;
-            //      ,       1  
-            std::queue< std::pair< size_t, size_t > > opened;
-            planes.push_back(initConvexHull(segments, opened));
-            while (!opened.empty()) {
-                std::pair< size_t, size_t > segment = opened.front();
-                opened.pop();
-                Point normal = segments[segment];
-                if (normal == Point(0, 0, 0))
-                    continue;
-                //    0  pi       
-                //,   ,   cos * fabs(cos)
-                long double maxSqrCos = -2;
-                size_t newPoint;
-                for (size_t i = 0; i < points.size(); i++)
-                    if (i != segment.first && i != segment.second) {
-                        Point nextNormal = Plane(points[segment.first], points[segment.second], points[i]).normal();
-                        long double sqrCos = (normal * nextNormal) * fabs(normal * nextNormal) 
-                            / normal.sqrLength() / nextNormal.sqrLength();
-                        if (sqrCos > maxSqrCos) {
-                            maxSqrCos = sqrCos;
-                            newPoint = i;
-                        }
-                    }
-                planes.push_back(addPlane(segments, opened, segment.first, segment.second, newPoint));
-            }
+            Hull hull;
+            hull.pointConflicts.resize(points.size());
+            initHull(hull, simplex);
+            std::vector< size_t > order;
+            for (size_t i = 0; i < points.size(); i++)
+                if (i != simplex[0] && i != simplex[1] && i != simplex[2] && i != simplex[3])
+                    order.push_back(i);
+            std::mt19937 random(points.size());
+            std::shuffle(order.begin(), order.end(), random);
+            for (size_t i = 0; i < order.size(); i++)
+                for (size_t face = 0; face < 4; face++)
+                    if (sees(hull, order[i], face))
+                        addConflict(hull, face, order[i]);
+            std::vector< size_t > startsAt(points.size()), mark(points.size(), -1);
+            for (size_t i = 0; i < order.size(); i++)
+                addPoint(hull, order[i], startsAt, mark);
+            for (size_t i = 0; i < hull.faces.size(); i++)
+                if (hull.faces[i].alive)
+                    planes.push_back(std::vector< size_t >(hull.faces[i].vertices, hull.faces[i].vertices + 3));
         }
     };
 };
\ No newline at end of file
@@ -0,0 +1,231 @@
+#ifndef _PREDICATES_H_
+#define _PREDICATES_H_
+
+#include <cmath>
+#include <vector>
+
+// Точные предикаты ориентации и вписанной сферы по Шевчуку: сначала вычисление в double с оценкой
+// погрешности, и только если знак под сомнением - точно, в арифметике разложений (expansions).
+// Знак точен, если координаты точек представимы в double, а double вычисляется с округлением к
+// ближайшему (SSE2; на x87 нужен -mfpmath=sse)
+namespace geometry {
+namespace predicates {
+
+    // разложение - сумма неперекрывающихся double по возрастанию модуля, без нулей
+    typedef std::vector< double > Expansion;
+
+    const double epsilon = std::ldexp(1.0, -53);
+    // 2^27 + 1: делит 53-битную мантиссу на две половины по 26 бит
+    const double splitter = std::ldexp(1.0, 27) + 1;
+    const double orientBound = (7 + 56 * epsilon) * epsilon;
+    const double insphereBound = (16 + 224 * epsilon) * epsilon;
+
+    // x + y == a + b точно, x - округленная сумма
+    inline void twoSum(double a, double b, double &x, double &y) {
+        x = a + b;
+        double bVirtual = x - a;
+        double aVirtual = x - bVirtual;
+        y = (a - aVirtual) + (b - bVirtual);
+    }
+
+    // то же при |a| >= |b|
+    inline void fastTwoSum(double a, double b, double &x, double &y) {
+        x = a + b;
+        y = b - (x - a);
+    }
+
+    inline void split(double a, double &high, double &low) {
+        double c = splitter * a;
+        high = c - (c - a);
+        low = a - high;
+    }
+
+    // x + y == a * b точно (Деккер)
+    inline void twoProduct(double a, double b, double &x, double &y) {
+        x = a * b;
+        double aHigh, aLow, bHigh, bLow;
+        split(a, aHigh, aLow);
+        split(b, bHigh, bLow);
+        y = aLow * bLow - (((x - aHigh * bHigh) - aLow * bHigh) - aHigh * bLow);
+    }
+
+    // a - b как разложение
+    Expansion difference(double a, double b) {
+        double x, y;
+        twoSum(a, -b, x, y);
+        Expansion result;
+        if (y != 0)
+            result.push_back(y);
+        if (x != 0 || result.empty())
+            result.push_back(x);
+        return result;
+    }
+
+    // fast_expansion_sum_zeroelim
+    Expansion operator+(const Expansion &e, const Expansion &f) {
+        Expansion h;
+        size_t i = 0, j = 0;
+        double q, sum, error;
+        if ((f[0] > e[0]) == (f[0] > -e[0]))
+            q = e[i++];
+        else
+            q = f[j++];
+        if (i < e.size() && j < f.size()) {
+            if ((f[j] > e[i]) == (f[j] > -e[i]))
+                fastTwoSum(e[i++], q, sum, error);
+            else
+                fastTwoSum(f[j++], q, sum, error);
+            q = sum;
+            if (error != 0)
+                h.push_back(error);
+            while (i < e.size() && j < f.size()) {
+                if ((f[j] > e[i]) == (f[j] > -e[i]))
+                    twoSum(q, e[i++], sum, error);
+                else
+                    twoSum(q, f[j++], sum, error);
+                q = sum;
+                if (error != 0)
+                    h.push_back(error);
+            }
+        }
+        for (; i < e.size(); i++) {
+            twoSum(q, e[i], sum, error);
+            q = sum;
+            if (error != 0)
+                h.push_back(error);
+        }
+        for (; j < f.size(); j++) {
+            twoSum(q, f[j], sum, error);
+            q = sum;
+            if (error != 0)
+                h.push_back(error);
+        }
+        if (q != 0 || h.empty())
+            h.push_back(q);
+        return h;
+    }
+
+    Expansion operator-(const Expansion &e) {
+        Expansion result(e);
+        for (size_t i = 0; i < result.size(); i++)
+            result[i] = -result[i];
+        return result;
+    }
+
+    Expansion operator-(const Expansion &e, const Expansion &f) {
+        return e + (-f);
+    }
+
+    // scale_expansion_zeroelim
+    Expansion operator*(const Expansion &e, double b) {
+        Expansion h;
+        double q, error, high, low, sum;
+        twoProduct(e[0], b, q, error);
+        if (error != 0)
+            h.push_back(error);
+        for (size_t i = 1; i < e.size(); i++) {
+            twoProduct(e[i], b, high, low);
+            twoSum(q, low, sum, error);
+            if (error != 0)
+                h.push_back(error);
+            fastTwoSum(high, sum, q, error);
+            if (error != 0)
+                h.push_back(error);
+        }
+        if (q != 0 || h.empty())
+            h.push_back(q);
+        return h;
+    }
+
+    Expansion operator*(const Expansion &e, const Expansion &f) {
+        Expansion result = e * f[0];
+        for (size_t i = 1; i < f.size(); i++)
+            result = result + e * f[i];
+        return result;
+    }
+
+    // старшая компонента разложения имеет его знак
+    inline double estimate(const Expansion &e) {
+        return e.back();
+    }
+
+    // точные вычисления по тем же формулам, что и быстрые, поэтому знаки согласованы
+    double orient3dExact(const double *a, const double *b, const double *c, const double *d) {
+        Expansion ux = difference(b[0], a[0]), uy = difference(b[1], a[1]), uz = difference(b[2], a[2]);
+        Expansion vx = difference(c[0], a[0]), vy = difference(c[1], a[1]), vz = difference(c[2], a[2]);
+        Expansion wx = difference(d[0], a[0]), wy = difference(d[1], a[1]), wz = difference(d[2], a[2]);
+        return estimate(ux * (vy * wz - vz * wy) + vx * (wy * uz - wz * uy) + wx * (uy * vz - uz * vy));
+    }
+
+    double insphereExact(const double *a, const double *b, const double *c, const double *d, const double *e) {
+        Expansion aex = difference(a[0], e[0]), aey = difference(a[1], e[1]), aez = difference(a[2], e[2]);
+        Expansion bex = difference(b[0], e[0]), bey = difference(b[1], e[1]), bez = difference(b[2], e[2]);
+        Expansion cex = difference(c[0], e[0]), cey = difference(c[1], e[1]), cez = difference(c[2], e[2]);
+        Expansion dex = difference(d[0], e[0]), dey = difference(d[1], e[1]), dez = difference(d[2], e[2]);
+        Expansion ab = aex * bey - bex * aey, bc = bex * cey - cex * bey, cd = cex * dey - dex * cey;
+        Expansion da = dex * aey - aex * dey, ac = aex * cey - cex * aey, bd = bex * dey - dex * bey;
+        Expansion abc = aez * bc - bez * ac + cez * ab;
+        Expansion bcd = bez * cd - cez * bd + dez * bc;
+        Expansion cda = cez * da + dez * ac + aez * cd;
+        Expansion dab = dez * ab + aez * bd + bez * da;
+        Expansion aLift = aex * aex + aey * aey + aez * aez, bLift = bex * bex + bey * bey + bez * bez;
+        Expansion cLift = cex * cex + cey * cey + cez * cez, dLift = dex * dex + dey * dey + dez * dez;
+        return -estimate((dLift * abc - cLift * dab) + (bLift * cda - aLift * bcd));
+    }
+
+    // знак ((b - a) ^ (c - a)) * (d - a): положителен, если d с той стороны плоскости (a, b, c),
+    // куда смотрит нормаль по правилу буравчика
+    double orient3d(const double *a, const double *b, const double *c, const double *d) {
+        double ux = b[0] - a[0], uy = b[1] - a[1], uz = b[2] - a[2];
+        double vx = c[0] - a[0], vy = c[1] - a[1], vz = c[2] - a[2];
+        double wx = d[0] - a[0], wy = d[1] - a[1], wz = d[2] - a[2];
+        double vywz = vy * wz, vzwy = vz * wy;
+        double wyuz = wy * uz, wzuy = wz * uy;
+        double uyvz = uy * vz, uzvy = uz * vy;
+        double det = ux * (vywz - vzwy) + vx * (wyuz - wzuy) + wx * (uyvz - uzvy);
+        double permanent = (std::fabs(vywz) + std::fabs(vzwy)) * std::fabs(ux)
+            + (std::fabs(wyuz) + std::fabs(wzuy)) * std::fabs(vx)
+            + (std::fabs(uyvz) + std::fabs(uzvy)) * std::fabs(wx);
+        double bound = orientBound * permanent;
+        if (det > bound || -det > bound)
+            return det;
+        return orient3dExact(a, b, c, d);
+    }
+
+    // положителен, если e внутри сферы через a, b, c, d при orient3d(a, b, c, d) > 0
+    // (при отрицательной ориентации знак обратный), ноль - на сфере
+    double insphere(const double *a, const double *b, const double *c, const double *d, const double *e) {
+        double aex = a[0] - e[0], aey = a[1] - e[1], aez = a[2] - e[2];
+        double bex = b[0] - e[0], bey = b[1] - e[1], bez = b[2] - e[2];
+        double cex = c[0] - e[0], cey = c[1] - e[1], cez = c[2] - e[2];
+        double dex = d[0] - e[0], dey = d[1] - e[1], dez = d[2] - e[2];
+        double aexbey = aex * bey, bexaey = bex * aey, bexcey = bex * cey, cexbey = cex * bey;
+        double cexdey = cex * dey, dexcey = dex * cey, dexaey = dex * aey, aexdey = aex * dey;
+        double aexcey = aex * cey, cexaey = cex * aey, bexdey = bex * dey, dexbey = dex * bey;
+        double ab = aexbey - bexaey, bc = bexcey - cexbey, cd = cexdey - dexcey;
+        double da = dexaey - aexdey, ac = aexcey - cexaey, bd = bexdey - dexbey;
+        double abc = aez * bc - bez * ac + cez * ab;
+        double bcd = bez * cd - cez * bd + dez * bc;
+        double cda = cez * da + dez * ac + aez * cd;
+        double dab = dez * ab + aez * bd + bez * da;
+        double aLift = aex * aex + aey * aey + aez * aez, bLift = bex * bex + bey * bey + bez * bez;
+        double cLift = cex * cex + cey * cey + cez * cez, dLift = dex * dex + dey * dey + dez * dez;
+        double det = (dLift * abc - cLift * dab) + (bLift * cda - aLift * bcd);
+        double aezAbs = std::fabs(aez), bezAbs = std::fabs(bez), cezAbs = std::fabs(cez), dezAbs = std::fabs(dez);
+        aexbey = std::fabs(aexbey); bexaey = std::fabs(bexaey); bexcey = std::fabs(bexcey);
+        cexbey = std::fabs(cexbey); cexdey = std::fabs(cexdey); dexcey = std::fabs(dexcey);
+        dexaey = std::fabs(dexaey); aexdey = std::fabs(aexdey); aexcey = std::fabs(aexcey);
+        cexaey = std::fabs(cexaey); bexdey = std::fabs(bexdey); dexbey = std::fabs(dexbey);
+        double permanent = ((cexdey + dexcey) * bezAbs + (dexbey + bexdey) * cezAbs + (bexcey + cexbey) * dezAbs) * aLift
+            + ((dexaey + aexdey) * cezAbs + (aexcey + cexaey) * dezAbs + (cexdey + dexcey) * aezAbs) * bLift
+            + ((aexbey + bexaey) * dezAbs + (bexdey + dexbey) * aezAbs + (dexaey + aexdey) * bezAbs) * cLift
+            + ((bexcey + cexbey) * aezAbs + (cexaey + aexcey) * bezAbs + (aexbey + bexaey) * cezAbs) * dLift;
+        double bound = insphereBound * permanent;
+        if (det > bound || -det > bound)
+            return -det;
+        return insphereExact(a, b, c, d, e);
+    }
+}
+}
+
+#endif
@@ -0,0 +1,249 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#include "../Ukkonen/SuffixTree.hpp"
+#include "../suffixAutomata/SuffixAutomaton.hpp"
+#include "../SuffixArray/SuffixArray.hpp"
+#include "../SuffixArray/BenchmarkTexts.hpp"
+
+// сравнение суффиксного дерева Укконена, суффиксного автомата и суффиксного массива на одних входах:
+// время построения, прирост пиковой памяти процесса, байт на символ, поиск подстрок и наибольшая общая подстрока.
+// Каждая структура строится в отдельном процессе (fork), чтобы пиковая память не смешивалась.
+// usage: benchmark [size] [queries] [csv|json] [file...]
+
+// строка результата лежит в общей с дочерним процессом памяти, поэтому без std::string
+struct Result {
+  char input[64];
+  char structure[16];
+  char operation[16];
+  size_t size;
+  size_t count;
+  double seconds;
+  size_t memory;     // память структуры по ее собственному подсчету
+  size_t peakGrowth; // на сколько выросла пиковая память процесса после fork
+  size_t checksum;   // сводка ответов, у всех структур должна совпадать
+  bool agree;
+};
+
+struct Workload {
+  std::string name;
+  std::string text;
+  // образцы: половина - подстроки текста, половина - случайные строки
+  std::vector < std::string > patterns;
+  // строки, с которыми ищется наибольшая общая подстрока
+  std::vector < std::string > others;
+};
+
+// пиковая память процесса в байтах
+size_t peakMemory() {
+  rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss * (size_t) 1024;
+}
+
+void fill(Result &result, const Workload &workload, const char *structure, const char *operation, size_t count) {
+  memset(&result, 0, sizeof(Result));
+  strncpy(result.input, workload.name.c_str(), sizeof(result.input) - 1);
+  strncpy(result.structure, structure, sizeof(result.structure) - 1);
+  strncpy(result.operation, operation, sizeof(result.operation) - 1);
+  result.size = workload.text.size();
+  result.count = count;
+}
+
+// Index - обертка над структурой с методами build, memory, contains и longestCommonSubstring
+template < class Index >
+void measure(const Workload &workload, const char *structure, Result *results) {
+  size_t basePeak = peakMemory();
+  Index index;
+  fill(results[0], workload, structure, "build", 1);
+  clock_t begin = clock();
+  index.build(workload.text);
+  results[0].seconds = elapsed(begin);
+  results[0].memory = index.memory();
+  results[0].peakGrowth = peakMemory() - basePeak;
+
+  fill(results[1], workload, structure, "contains", workload.patterns.size());
+  begin = clock();
+  for(size_t i = 0; i < workload.patterns.size(); i++)
+    results[1].checksum = results[1].checksum * 31 + index.contains(workload.patterns[i]);
+  results[1].seconds = elapsed(begin);
+
+  fill(results[2], workload, structure, "lcs", workload.others.size());
+  begin = clock();
+  for(size_t i = 0; i < workload.others.size(); i++)
+    results[2].checksum = results[2].checksum * 31 + index.longestCommonSubstring(workload.others[i]);
+  results[2].seconds = elapsed(begin);
+
+  for(int i = 1; i < 3; i++) {
+    results[i].memory = results[0].memory;
+    results[i].peakGrowth = peakMemory() - basePeak;
+  }
+}
+
+struct TreeIndex {
+  SuffixTree tree;
+  void build(const std::string &text) {
+    tree = SuffixTree(text);
+  }
+  size_t memory() const {
+    return tree.memory();
+  }
+  bool contains(const std::string &pattern) const {
+    return tree.contains(pattern);
+  }
+  size_t longestCommonSubstring(const std::string &other) {
+    size_t position;
+    return tree.longestCommonSubstring(other, position);
+  }
+};
+
+struct AutomatonIndex {
+  SuffixAutomaton automaton;
+  void build(const std::string &text) {
+    automaton = SuffixAutomaton(text);
+  }
+  size_t memory() const {
+    return automaton.memory();
+  }
+  bool contains(const std::string &pattern) const {
+    return automaton.contains(pattern);
+  }
+  size_t longestCommonSubstring(const std::string &other) const {
+    size_t position;
+    return automaton.longestCommonSubstring(other, position);
+  }
+};
+
+// суффиксный массив не умеет дописывать строку, поэтому наибольшая общая подстрока
+// каждый раз строит массив склейки: это и есть цена запроса
+struct ArrayIndex {
+  std::string text;
+  std::vector < int > suffArray;
+  void build(const std::string &text) {
+    this->text = text;
+    suffixArray(text, suffArray);
+  }
+  size_t memory() const {
+    return suffArray.capacity() * sizeof(int) + text.capacity();
+  }
+  bool contains(const std::string &pattern) const {
+    int left = binSearch(text, pattern, suffArray, true);
+    return text.compare(suffArray[left], pattern.size(), pattern) == 0;
+  }
+  size_t longestCommonSubstring(const std::string &other) const {
+    int position;
+    return ::longestCommonSubstring(text, other, position);
+  }
+};
+
+// замер в дочернем процессе, результаты он пишет в общую память
+template < class Index >
+void run(const Workload &workload, const char *structure, std::vector < Result > &results) {
+  Result *shared = (Result *) mmap(NULL, 3 * sizeof(Result), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  pid_t child = fork();
+  if(child == 0) {
+    measure < Index >(workload, structure, shared);
+    _exit(0);
+  }
+  int status = 0;
+  waitpid(child, &status, 0);
+  if(WIFEXITED(status) && WEXITSTATUS(status) == 0)
+    results.insert(results.end(), shared, shared + 3);
+  else
+    std::cerr << structure << " failed on " << workload.name << std::endl;
+  munmap(shared, 3 * sizeof(Result));
+}
+
+void benchmark(const std::string &name, const std::string &text, size_t queries, std::vector < Result > &results) {
+  Workload workload;
+  workload.name = name;
+  workload.text = text;
+  std::string alphabet = text.empty() ? "a" : text.substr(0, 64);
+  for(size_t i = 0; i < queries; i++) {
+    size_t length = std::min(text.size(), (size_t) 8);
+    if(i % 2 == 0)
+      workload.patterns.push_back(text.substr(rand() % (text.size() - length + 1), length));
+    else
+      workload.patterns.push_back(randomString(8, alphabet));
+  }
+  for(size_t i = 0; i < 3; i++)
+    workload.others.push_back(randomString(1000, alphabet));
+
+  size_t first = results.size();
+  run < TreeIndex >(workload, "ukkonen", results);
+  run < AutomatonIndex >(workload, "automaton", results);
+  run < ArrayIndex >(workload, "suffix-array", results);
+  // ответы каждой структуры сверяются с эталоном - первой структурой, выполнившей ту же операцию
+  for(size_t i = first; i < results.size(); i++) {
+    size_t reference = first;
+    while(strcmp(results[reference].operation, results[i].operation) != 0)
+      reference++;
+    results[i].agree = results[i].checksum == results[reference].checksum;
+  }
+}
+
+// в дробных байтах: у разных структур разница бывает меньше байта на букву
+double bytesPerChar(const Result &result) {
+  return (double) result.memory / std::max(result.size, (size_t) 1);
+}
+
+void printCSV(const std::vector < Result > &results) {
+  std::cout << "input,structure,operation,size,count,seconds,memory,bytesPerChar,peakGrowth,agree" << std::endl;
+  for(size_t i = 0; i < results.size(); i++)
+    std::cout << results[i].input << ',' << results[i].structure << ',' << results[i].operation << ','
+      << results[i].size << ',' << results[i].count << ',' << results[i].seconds << ',' << results[i].memory << ','
+      << bytesPerChar(results[i]) << ',' << results[i].peakGrowth << ','
+      << (results[i].agree ? "yes" : "no") << std::endl;
+}
+
+void printJSON(const std::vector < Result > &results) {
+  std::cout << '[' << std::endl;
+  for(size_t i = 0; i < results.size(); i++)
+    std::cout << "  {\"input\": \"" << results[i].input << "\", \"structure\": \"" << results[i].structure
+      << "\", \"operation\": \"" << results[i].operation << "\", \"size\": " << results[i].size
+      << ", \"count\": " << results[i].count << ", \"seconds\": " << results[i].seconds
+      << ", \"memory\": " << results[i].memory
+      << ", \"bytesPerChar\": " << bytesPerChar(results[i])
+      << ", \"peakGrowth\": " << results[i].peakGrowth << ", \"agree\": " << (results[i].agree ? "true" : "false")
+      << '}' << (i + 1 < results.size() ? "," : "") << std::endl;
+  std::cout << ']' << std::endl;
+}
+
+int main(int argc, char **argv) {
+  size_t size = argc > 1 ? atol(argv[1]) : 1000000;
+  size_t queries = argc > 2 ? atol(argv[2]) : 10000;
+  std::string format = argc > 3 ? argv[3] : "csv";
+  srand(1);
+  std::vector < Result > results;
+  benchmark("random", randomString(size, "abcdefghijklmnopqrstuvwxyz"), queries, results);
+  benchmark("dna", randomString(size, "acgt"), queries, results);
+  benchmark("fibonacci", fibonacciString(size), queries, results);
+  benchmark("period", std::string(size, 'a'), queries, results);
+  // остальные аргументы - файлы с настоящим текстом
+  for(int i = 4; i < argc; i++) {
+    std::ifstream in(argv[i]);
+    std::stringstream text;
+    text << in.rdbuf();
+    benchmark(argv[i], text.str(), queries, results);
+  }
+  if(format == "json")
+    printJSON(results);
+  else
+    printCSV(results);
+  bool agree = true;
+  for(size_t i = 0; i < results.size(); i++)
+    agree = agree && results[i].agree;
+  return !agree;
+}
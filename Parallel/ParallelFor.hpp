@@ -0,0 +1,31 @@
+#ifndef _PARALLEL_FOR_
+#define _PARALLEL_FOR_
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+
+// function(i) для всех i из [0, count) в threadsNumber потоках (нужны -std=c++11 -pthread).
+// Потоки разбирают номера по общему счетчику без блокировок, так что долгие задачи не тормозят
+// остальные потоки. function вызывается одновременно из разных потоков с разными i
+template < class Function >
+void parallelFor(size_t count, size_t threadsNumber, Function function) {
+    threadsNumber = std::min(std::max(threadsNumber, (size_t) 1), count);
+    if (threadsNumber <= 1) {
+        for (size_t i = 0; i < count; i++)
+            function(i);
+        return;
+    }
+    std::atomic < size_t > next(0);
+    std::vector < std::thread > threads;
+    for (size_t i = 0; i < threadsNumber; i++)
+        threads.push_back(std::thread([&]() {
+            for (size_t job = next++; job < count; job = next++)
+                function(job);
+        }));
+    for (size_t i = 0; i < threads.size(); i++)
+        threads[i].join();
+}
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef _APPROXIMATE_SEARCH_
+#define _APPROXIMATE_SEARCH_
+
+#include <string>
+#include <vector>
+#include <thread>
+
+#include "FMIndex.hpp"
+#include "../Parallel/ParallelFor.hpp"
+
+// приближенный поиск набора образцов в несколько потоков (нужны -std=c++11 -pthread).
+// Индекс только читается, поэтому образцы раздаются потокам через parallelFor без блокировок
+void approximateLocateAll(const FMIndex &index, const std::vector < std::string > &patterns, int k, bool edits,
+                          std::vector < std::vector < std::pair < int, int > > > &results,
+                          size_t threadsNumber = std::thread::hardware_concurrency()) {
+  results.assign(patterns.size(), std::vector < std::pair < int, int > >());
+  parallelFor(patterns.size(), threadsNumber, [&](size_t pattern) {
+    index.approximateLocate(patterns[pattern], k, edits, results[pattern]);
+  });
+}
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef _BENCHMARK_TEXTS_
+#define _BENCHMARK_TEXTS_
+
+#include <string>
+#include <cstdlib>
+#include <ctime>
+
+// общие входы и замер времени для замеров SuffixArray/benchmark и IndexBenchmark
+
+std::string randomString(size_t size, const std::string &alphabet) {
+  std::string result(size, 0);
+  for(size_t i = 0; i < size; i++)
+    result[i] = alphabet[rand() % alphabet.size()];
+  return result;
+}
+
+// строки Фибоначчи - худший случай для удвоения префиксов: число шагов log n и длинные lcp,
+// а для деревьев и автоматов - много повторов
+std::string fibonacciString(size_t size) {
+  std::string previous = "b", current = "a";
+  while(current.size() < size) {
+    std::string next = current + previous;
+    previous.swap(current);
+    current.swap(next);
+  }
+  return current.substr(0, size);
+}
+
+double elapsed(clock_t begin) {
+  return (clock() - begin + .0) / CLOCKS_PER_SEC;
+}
+
+#endif
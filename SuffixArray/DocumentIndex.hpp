@@ -0,0 +1,133 @@
+#ifndef _DOCUMENT_INDEX_
+#define _DOCUMENT_INDEX_
+
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "SuffixArray.hpp"
+
+// обобщенный суффиксный массив над набором документов.
+// Документы склеиваются через разделитель - символ 256 целочисленного алфавита, поэтому в документах
+// может встречаться любой байт
+class DocumentIndex {
+  enum { SEPARATOR = 1 << 8 * sizeof(char) };
+  // склейка: байты документов и разделители
+  std::vector < int > text;
+  std::vector < int > suffArray;
+  // documentStarts[d] - позиция начала документа d в склейке
+  std::vector < int > documentStarts;
+  // documents[i] - документ суффикса suffArray[i], -1 для разделителей и терминатора
+  std::vector < int > documents;
+  // previous[i] - ближайшая строка слева с тем же документом (алгоритм Мутукришнана)
+  std::vector < int > previous;
+  // дерево отрезков: индекс минимума previous на отрезке
+  std::vector < int > minTree;
+  size_t treeSize;
+
+  int minPosition(int first, int second) const {
+    if(first == -1)
+      return second;
+    if(second == -1)
+      return first;
+    return previous[second] < previous[first] ? second : first;
+  }
+
+  // индекс минимума previous на [left..right)
+  int rangeMin(size_t left, size_t right) const {
+    int result = -1;
+    for(left += treeSize, right += treeSize; left < right; left /= 2, right /= 2) {
+      if(left & 1)
+        result = minPosition(result, minTree[left++]);
+      if(right & 1)
+        result = minPosition(result, minTree[--right]);
+    }
+    return result;
+  }
+
+  // строки суффиксного массива [left..right), начинающиеся с pattern
+  bool range(const std::string &pattern, int &left, int &right) const {
+    if(pattern.empty())
+      return false;
+    std::vector < int > symbols(pattern.size());
+    for(size_t i = 0; i < pattern.size(); i++)
+      symbols[i] = (unsigned char) pattern[i];
+    left = binSearch(text, symbols, suffArray, true);
+    right = binSearch(text, symbols, suffArray, false) + 1;
+    if(left + 1 == right && (suffArray[left] + symbols.size() > text.size() ||
+      !std::equal(symbols.begin(), symbols.end(), text.begin() + suffArray[left])))
+      return false;
+    return left < right;
+  }
+
+public:
+  DocumentIndex(const std::vector < std::string > &texts) {
+    for(size_t i = 0; i < texts.size(); i++) {
+      documentStarts.push_back(text.size());
+      for(size_t j = 0; j < texts[i].size(); j++)
+        text.push_back((unsigned char) texts[i][j]);
+      text.push_back(SEPARATOR);
+    }
+    suffixArray(text, suffArray, SEPARATOR + 1);
+    documents.assign(suffArray.size(), -1);
+    previous.assign(suffArray.size(), -1);
+    std::vector < int > last(texts.size(), -1);
+    for(size_t i = 0; i < suffArray.size(); i++) {
+      if(suffArray[i] == (int) text.size() || text[suffArray[i]] == SEPARATOR)
+        continue;
+      int document = std::upper_bound(documentStarts.begin(), documentStarts.end(), suffArray[i])
+        - documentStarts.begin() - 1;
+      documents[i] = document;
+      previous[i] = last[document];
+      last[document] = i;
+    }
+    for(treeSize = 1; treeSize < suffArray.size(); treeSize *= 2);
+    minTree.assign(2 * treeSize, -1);
+    for(size_t i = 0; i < suffArray.size(); i++)
+      minTree[treeSize + i] = i;
+    for(size_t i = treeSize - 1; i > 0; i--)
+      minTree[i] = minPosition(minTree[2 * i], minTree[2 * i + 1]);
+  }
+
+  size_t documentsNumber() const {
+    return documentStarts.size();
+  }
+
+  // все вхождения как пары (документ, позиция в документе)
+  void find(const std::string &pattern, std::vector < std::pair < int, int > > &positions) const {
+    int left, right;
+    if(!range(pattern, left, right))
+      return;
+    for(int i = left; i < right; i++)
+      positions.push_back(std::make_pair(documents[i], suffArray[i] - documentStarts[documents[i]]));
+  }
+
+  // документы, содержащие pattern, без перебора всех вхождений: O(ответ * log n)
+  void listDocuments(const std::string &pattern, std::vector < int > &result) const {
+    int left, right;
+    if(!range(pattern, left, right))
+      return;
+    // первое вхождение документа в [left..right) - то, у которого previous < left
+    std::vector < std::pair < int, int > > segments(1, std::make_pair(left, right));
+    while(!segments.empty()) {
+      std::pair < int, int > segment = segments.back();
+      segments.pop_back();
+      if(segment.first >= segment.second)
+        continue;
+      int position = rangeMin(segment.first, segment.second);
+      if(previous[position] >= left)
+        continue;
+      result.push_back(documents[position]);
+      segments.push_back(std::make_pair(segment.first, position));
+      segments.push_back(std::make_pair(position + 1, segment.second));
+    }
+  }
+
+  size_t countDocuments(const std::string &pattern) const {
+    std::vector < int > result;
+    listDocuments(pattern, result);
+    return result.size();
+  }
+};
+
+#endif
@@ -0,0 +1,342 @@
+#ifndef _FM_INDEX_
+#define _FM_INDEX_
+
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "SuffixArray.hpp"
+
+// битовый вектор с rank за O(1): на каждые 8 слов по 64 бита хранится число единиц до них
+class RankBitVector {
+  std::vector < unsigned long long > words;
+  std::vector < unsigned int > blocks;
+public:
+  RankBitVector(size_t size = 0): words(size / 64 + 1, 0) {}
+
+  void set(size_t i) {
+    words[i >> 6] |= 1ULL << (i & 63);
+  }
+  bool get(size_t i) const {
+    return (words[i >> 6] >> (i & 63)) & 1;
+  }
+  // вызывается один раз после всех set
+  void build() {
+    blocks.assign(words.size() / 8 + 1, 0);
+    unsigned int ones = 0;
+    for(size_t i = 0; i < words.size(); i++) {
+      if(i % 8 == 0)
+        blocks[i / 8] = ones;
+      ones += __builtin_popcountll(words[i]);
+    }
+  }
+  // число единиц на [0..i)
+  size_t rank1(size_t i) const {
+    size_t word = i >> 6;
+    size_t result = blocks[word >> 3];
+    for(size_t j = word & ~(size_t) 7; j < word; j++)
+      result += __builtin_popcountll(words[j]);
+    if(i & 63)
+      result += __builtin_popcountll(words[word] & ((1ULL << (i & 63)) - 1));
+    return result;
+  }
+  size_t rank0(size_t i) const {
+    return i - rank1(i);
+  }
+  size_t memory() const {
+    return words.size() * sizeof(unsigned long long) + blocks.size() * sizeof(unsigned int);
+  }
+};
+
+// wavelet matrix над кодами [0..alphabetSize): на каждом уровне - один бит кода, access и rank за O(log alphabetSize)
+class WaveletMatrix {
+  int levels;
+  std::vector < RankBitVector > bits;
+  // zeros[level] - число нулей на уровне
+  std::vector < size_t > zeros;
+  // starts[c] - где начинаются коды c после последнего уровня
+  std::vector < size_t > starts;
+public:
+  WaveletMatrix(): levels(0) {}
+
+  WaveletMatrix(std::vector < int > sequence, int alphabetSize): levels(0) {
+    while((1 << levels) < alphabetSize)
+      levels++;
+    size_t size = sequence.size();
+    // строим уровни, на каждом стабильно разделяя нули и единицы
+    std::vector < int > next(size);
+    for(int level = 0; level < levels; level++) {
+      int shift = levels - level - 1;
+      bits.push_back(RankBitVector(size));
+      size_t zeroCount = 0;
+      for(size_t i = 0; i < size; i++)
+        if((sequence[i] >> shift) & 1)
+          bits[level].set(i);
+        else
+          next[zeroCount++] = sequence[i];
+      zeros.push_back(zeroCount);
+      for(size_t i = 0, ones = zeroCount; i < size; i++)
+        if((sequence[i] >> shift) & 1)
+          next[ones++] = sequence[i];
+      bits[level].build();
+      sequence.swap(next);
+    }
+    starts.assign(alphabetSize, 0);
+    for(size_t i = size; i > 0; i--)
+      starts[sequence[i - 1]] = i - 1;
+  }
+
+  // код в позиции row и его rank на [0..row) одним спуском
+  int access(size_t row, size_t &rank) const {
+    int code = 0;
+    for(int level = 0; level < levels; level++) {
+      bool bit = bits[level].get(row);
+      code = code << 1 | bit;
+      row = bit ? zeros[level] + bits[level].rank1(row) : bits[level].rank0(row);
+    }
+    rank = row - starts[code];
+    return code;
+  }
+
+  // число кодов code на [0..row)
+  size_t rank(int code, size_t row) const {
+    for(int level = 0; level < levels; level++) {
+      if((code >> (levels - level - 1)) & 1)
+        row = zeros[level] + bits[level].rank1(row);
+      else
+        row = bits[level].rank0(row);
+    }
+    return row - starts[code];
+  }
+
+  size_t memory() const {
+    size_t result = (zeros.size() + starts.size()) * sizeof(size_t);
+    for(size_t i = 0; i < bits.size(); i++)
+      result += bits[i].memory();
+    return result;
+  }
+};
+
+// FM-индекс: BWT в wavelet matrix + выборка суффиксного массива.
+// Сам текст и полный суффиксный массив после построения не хранятся
+class FMIndex {
+  // буквы текста (в том числе '\0') перенумерованы подряд с 1, код 0 - терминатор
+  std::vector < int > codes;
+  std::vector < unsigned char > letters;
+  WaveletMatrix bwt;
+  // BWT перевернутого текста: расширение образца вправо, нужно только для оценки errorsBound.
+  // Строится, только если индекс создан для приближенного поиска
+  WaveletMatrix reverseBwt;
+  bool approximate;
+  // less[c] - число букв текста, меньших c
+  std::vector < size_t > less;
+  // сохранены позиции, кратные sampleRate; sampled отмечает такие строки BWT
+  RankBitVector sampled;
+  std::vector < int > samples;
+  size_t sampleRate;
+  size_t bwtSize;
+
+  // коды BWT текста: буква перед каждым суффиксом в порядке суффиксного массива
+  void transform(const std::string &text, const std::vector < int > &suffArray, std::vector < int > &result) const {
+    result.resize(bwtSize);
+    for(size_t i = 0; i < bwtSize; i++) {
+      size_t position = (suffArray[i] + bwtSize - 1) % bwtSize;
+      result[i] = position < text.size() ? codes[(unsigned char) text[position]] : 0;
+    }
+  }
+
+  size_t LF(size_t row) const {
+    size_t rank;
+    int code = bwt.access(row, rank);
+    return less[code] + rank;
+  }
+
+  // сужение интервала [left..right) строк BWT приписыванием буквы code слева
+  void extend(int code, size_t &left, size_t &right) const {
+    left = less[code] + bwt.rank(code, left);
+    right = less[code] + bwt.rank(code, right);
+  }
+
+  // bound[i] - нижняя оценка числа ошибок в pattern[0..i]: число непересекающихся кусков,
+  // которых нет в тексте (D(i) в BWA). Кусок растет вправо поиском по BWT перевернутого текста,
+  // когда интервал пуст - ошибка и поиск заново со следующей буквы; всего O(m) сужений.
+  // Без reverseBwt оценка нулевая: перебор верен, но без отсечений
+  void errorsBound(const std::string &pattern, std::vector < int > &bound) const {
+    bound.assign(pattern.size(), 0);
+    if(!approximate)
+      return;
+    int errors = 0;
+    size_t left = 0, right = bwtSize;
+    for(size_t i = 0; i < pattern.size(); i++) {
+      int code = codes[(unsigned char) pattern[i]];
+      if(code >= 0) {
+        left = less[code] + reverseBwt.rank(code, left);
+        right = less[code] + reverseBwt.rank(code, right);
+      }
+      if(code < 0 || left >= right) {
+        errors++;
+        left = 0;
+        right = bwtSize;
+      }
+      bound[i] = errors;
+    }
+  }
+
+  // состояние перебора в approximateLocate
+  struct State {
+    size_t rest;  // сколько букв образца еще не сопоставлено
+    size_t left;
+    size_t right;
+    int errors;
+  };
+
+  // позиция суффикса в строке row: идем по LF до ближайшей сохраненной
+  int locateRow(size_t row) const {
+    int steps = 0;
+    // позиция 0 всегда в выборке, поэтому через терминатор не проходим
+    while(!sampled.get(row)) {
+      row = LF(row);
+      steps++;
+    }
+    return samples[sampled.rank1(row)] + steps;
+  }
+
+  // [left..right) - строки BWT, начинающиеся с pattern
+  bool backwardSearch(const std::string &pattern, size_t &left, size_t &right) const {
+    left = 0;
+    right = bwtSize;
+    for(size_t i = pattern.size(); i > 0 && left < right; i--) {
+      int code = codes[(unsigned char) pattern[i - 1]];
+      if(code < 0)
+        return false;
+      extend(code, left, right);
+    }
+    return left < right;
+  }
+
+public:
+  // approximate - строить и BWT перевернутого текста для быстрого approximateLocate;
+  // это вдвое больше памяти под BWT, поэтому для count и locate не нужно
+  FMIndex(const std::string &text, size_t sampleRate = 32, bool approximate = false):
+      codes(1 << 8 * sizeof(char), -1),
+      approximate(approximate),
+      sampleRate(sampleRate),
+      bwtSize(text.size() + 1) {
+    std::vector < int > suffArray;
+    suffixArray(text, suffArray);
+    // сжимаем алфавит до встретившихся букв; letters[0] - место терминатора
+    letters.push_back(0);
+    for(size_t i = 0; i < text.size(); i++)
+      codes[(unsigned char) text[i]] = 1;
+    for(int c = 0; c < (int) codes.size(); c++)
+      if(codes[c] != -1) {
+        codes[c] = letters.size();
+        letters.push_back(c);
+      }
+    std::vector < int > sequence;
+    transform(text, suffArray, sequence);
+    less.assign(letters.size() + 1, 0);
+    for(size_t i = 0; i < bwtSize; i++)
+      less[sequence[i] + 1]++;
+    for(size_t c = 1; c < less.size(); c++)
+      less[c] += less[c - 1];
+    bwt = WaveletMatrix(sequence, letters.size());
+    // выборка суффиксного массива
+    sampled = RankBitVector(bwtSize);
+    for(size_t i = 0; i < bwtSize; i++)
+      if(suffArray[i] % sampleRate == 0) {
+        sampled.set(i);
+        samples.push_back(suffArray[i]);
+      }
+    sampled.build();
+    if(!approximate)
+      return;
+    std::string reversed(text.rbegin(), text.rend());
+    suffixArray(reversed, suffArray);
+    transform(reversed, suffArray, sequence);
+    reverseBwt = WaveletMatrix(sequence, letters.size());
+  }
+
+  size_t count(const std::string &pattern) const {
+    size_t left, right;
+    if(!backwardSearch(pattern, left, right))
+      return 0;
+    return right - left;
+  }
+
+  // позиции вхождений в порядке суффиксного массива, как у find
+  void locate(const std::string &pattern, std::vector < int > &positions) const {
+    size_t left, right;
+    if(!backwardSearch(pattern, left, right))
+      return;
+    for(size_t row = left; row < right; row++)
+      positions.push_back(locateRow(row));
+  }
+
+  // вхождения pattern с не более чем k несовпадениями (или k правками, если edits) как пары
+  // (позиция, число ошибок), по возрастанию позиций. Перебор с возвратом по интервалам BWT
+  // с отсечением по оценке errorsBound; для правок позиция - начало совпавшего куска текста.
+  // Быстро - только у индекса, построенного с approximate
+  void approximateLocate(const std::string &pattern, int k, bool edits,
+                         std::vector < std::pair < int, int > > &positions) const {
+    std::vector < int > bound;
+    errorsBound(pattern, bound);
+    std::vector < std::pair < int, int > > found;
+    std::vector < State > stack;
+    State start = {pattern.size(), 0, bwtSize, 0};
+    stack.push_back(start);
+    while(!stack.empty()) {
+      State state = stack.back();
+      stack.pop_back();
+      if(state.rest == 0) {
+        for(size_t row = state.left; row < state.right; row++)
+          found.push_back(std::make_pair(locateRow(row), state.errors));
+        continue;
+      }
+      if(state.errors + bound[state.rest - 1] > k)
+        continue;
+      int code = codes[(unsigned char) pattern[state.rest - 1]];
+      for(int c = 1; c < (int) letters.size(); c++) {
+        State next = state;
+        extend(c, next.left, next.right);
+        if(next.left >= next.right)
+          continue;
+        // вставка в текст буквы, которой нет в образце; справа от образца вставлять бессмысленно
+        if(edits && state.errors < k && state.rest < pattern.size()) {
+          State inserted = next;
+          inserted.errors++;
+          stack.push_back(inserted);
+        }
+        next.rest--;
+        next.errors += c != code;
+        if(next.errors <= k)
+          stack.push_back(next);
+      }
+      // удаление буквы образца
+      if(edits && state.errors < k) {
+        State deleted = state;
+        deleted.rest--;
+        deleted.errors++;
+        stack.push_back(deleted);
+      }
+    }
+    // одна позиция могла найтись разными путями - оставляем минимум ошибок
+    std::sort(found.begin(), found.end());
+    for(size_t i = 0; i < found.size(); i++)
+      if(i == 0 || found[i].first != found[i - 1].first)
+        positions.push_back(found[i]);
+  }
+
+  // длина текста без терминатора
+  size_t size() const {
+    return bwtSize - 1;
+  }
+
+  // байты, занятые индексом
+  size_t memory() const {
+    return bwt.memory() + reverseBwt.memory() + sampled.memory() + samples.size() * sizeof(int)
+      + less.size() * sizeof(size_t) + codes.size() * sizeof(int) + letters.size();
+  }
+};
+
+#endif
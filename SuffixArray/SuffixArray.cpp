@@ -2,139 +2,74 @@
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <cstdlib>
 
-void suffixArray(const std::string &s, std::vector < int > &suffArray) {
-  const char *str = s.c_str();
-  int strSize = s.size() + 1;
-  int alphabetSize = (1 << 8 * sizeof(char));
-  //      
-  //       
-  std::vector < int > groups(alphabetSize, 0);
-  suffArray.assign(strSize, 0);
-  for(int i = 0; i < strSize; i++)
-    groups[(unsigned char) str[i]]++;
-  //    
-  for(int i = 1; i < alphabetSize; i++)
-    groups[i] += groups[i - 1];
-  for(int i = strSize - 1; i >= 0; i--)
-    suffArray[--groups[(unsigned char) str[i]]] = i;
-  //   
-  std::vector < int > classes(strSize, 0);
-  for(int i = 1; i < strSize; i++) {
-    classes[suffArray[i]] = classes[suffArray[i - 1]];
-    if(str[suffArray[i]] != str[suffArray[i - 1]])
-      classes[suffArray[i]]++;
-  }
-  //    
-  std::vector < int > newClasses;
-  //  2- 
-  std::vector < int > newSuffArray(strSize);
-  for(int step = 0; 1 << step < strSize; step++) {
-    //  2- 
-    for(int i = 0; i < strSize; i++)
-      newSuffArray[i] = (suffArray[i] - (1 << step) + 2 * strSize) % strSize;
-    //   1- 
-    groups.assign(strSize, 0);
-    for(int i = 0; i < strSize; i++)
-      groups[classes[suffArray[i]]]++;
-    for(int i = 1; i < groups.size(); i++)
-      groups[i] += groups[i - 1];
-    for(int i = strSize - 1; i >= 0; i--)
-      suffArray[--groups[classes[newSuffArray[i]]]] = newSuffArray[i];
-    //   
-    newClasses.assign(strSize, 0);
-    for(int i = 1; i < strSize; i++) {
-      newClasses[suffArray[i]] = newClasses[suffArray[i - 1]];
-      if((classes[suffArray[i]] != classes[suffArray[i - 1]]) || 
-        (classes[(suffArray[i] + (1 << step)) % strSize] != classes[(suffArray[i - 1] + (1 << step)) % strSize]))
-        newClasses[suffArray[i]]++;
-    }
-    classes.swap(newClasses);
-  }
-}
+#include "SuffixArray.hpp"
+#include "FMIndex.hpp"
+#include "DocumentIndex.hpp"
+#include "ApproximateSearch.hpp"
 
-int binSearch(const std::string &text, const std::string &pattern, const std::vector < int > &suffArray, bool isLower) {
-  const char *str = text.c_str();
-  // lower : (left...right]
-  // upper : [left...right)
-  int left = (isLower ? 0 : 1);
-  int right = text.size() + (isLower ? 0 : 1);
-  int matches = 0;
-  while(right - left > 1) {
-    int med = (left + right) / 2;
-    int medMatches;
-    // ,     
-    for(medMatches = matches; medMatches < pattern.size() &&
-      pattern[medMatches] == str[(suffArray[med] + medMatches) % suffArray.size()]; medMatches++);
-    if(isLower) {
-      if(medMatches != pattern.size() && pattern[medMatches] > str[(suffArray[med] + medMatches) % suffArray.size()])
-        left = med;
-      else
-        right = med;
-    } else {
-      if(medMatches != pattern.size() && pattern[medMatches] < str[(suffArray[med] + medMatches) % suffArray.size()])
-        right = med;
-      else
-        left = med;
-    }
-    //   
-    while(matches < medMatches && right < suffArray.size() && 
-      str[(suffArray[left] + matches) % suffArray.size()] == str[(suffArray[right] + matches) % suffArray.size()])
-      matches++;
+int main(int argc, char **argv) {
+  std::string text, pattern;
+  std::vector < int > positions;
+  // SuffixArray docs - на входе число документов, документы и образец; выводятся номера документов
+  if(argc > 1 && std::string(argv[1]) == "docs") {
+    int documentsNumber;
+    std::cin >> documentsNumber;
+    std::vector < std::string > documents(documentsNumber);
+    for(int i = 0; i < documentsNumber; i++)
+      std::cin >> documents[i];
+    std::cin >> pattern;
+    DocumentIndex index(documents);
+    index.listDocuments(pattern, positions);
+    std::sort(positions.begin(), positions.end());
+    std::cout << positions.size() << std::endl;
+    for(int i = 0; i < positions.size(); i++)
+      std::cout << positions[i] << ' ';
+    std::cout << std::endl;
+    return 0;
   }
-  return isLower ? right : left;
-}
-
-class Functor {
-    const std::string &pattern;
-    const std::string &text;
-public:
-    bool operator()(int left, int right) {
-        if (left == -1) {
-            return pattern < text.substr(right, std::min(pattern.size(), text.size() - right));
-        } else if (right == -1) {
-            return text.substr(left, std::min(pattern.size(), text.size() - left)) < pattern;
-        } else {
-            return text.substr(left, std::min(pattern.size(), text.size() - left)) < 
-                text.substr(right, std::min(pattern.size(), text.size() - right));
-        }
+  // SuffixArray approx k [edits] - на входе текст и образцы до конца файла;
+  // для каждого образца выводятся пары позиция:ошибки с не более чем k несовпадениями или правками
+  if(argc > 2 && std::string(argv[1]) == "approx") {
+    std::vector < std::string > patterns;
+    std::cin >> text;
+    while(std::cin >> pattern)
+      patterns.push_back(pattern);
+    FMIndex index(text, 32, true);
+    std::vector < std::vector < std::pair < int, int > > > results;
+    approximateLocateAll(index, patterns, atoi(argv[2]), argc > 3 && std::string(argv[3]) == "edits", results);
+    for(int i = 0; i < results.size(); i++) {
+      for(int j = 0; j < results[i].size(); j++)
+        std::cout << results[i][j].first << ':' << results[i][j].second << ' ';
+      std::cout << std::endl;
     }
-    Functor(const std::string &text, const std::string &pattern):
-        text(text),
-        pattern(pattern) {
+    return 0;
+  }
+  // SuffixArray words - на входе число слов текста, слова, число слов фразы, фраза; выводятся номера слов
+  if(argc > 1 && std::string(argv[1]) == "words") {
+    std::vector < std::string > words[2];
+    for(int k = 0; k < 2; k++) {
+      int wordsNumber;
+      std::cin >> wordsNumber;
+      words[k].resize(wordsNumber);
+      for(int i = 0; i < wordsNumber; i++)
+        std::cin >> words[k][i];
     }
-};
-
-void findUsingSTL(const std::string &text, const std::string &pattern, std::vector < int > &positions) {
-  std::vector < int > suffArray;
-  suffixArray(text, suffArray);
-  std::vector< int >::iterator begin;
-  std::vector< int >::iterator end;
-  Functor functor(text, pattern);
-  begin = std::lower_bound(suffArray.begin(), suffArray.end(), -1, functor);
-  end = std::upper_bound(suffArray.begin(), suffArray.end(), -1, functor);
-  if (begin != suffArray.end() && begin == end && text.substr(*begin, pattern.size()) != pattern) {
-      return;
+    std::map < std::string, int > dictionary;
+    std::vector < int > textTokens, patternTokens;
+    tokenize(words[0], dictionary, textTokens);
+    int alphabetSize = tokenize(words[1], dictionary, patternTokens);
+    find(textTokens, patternTokens, alphabetSize, positions);
+  } else if(argc > 1 && std::string(argv[1]) == "fm") {
+    // SuffixArray fm - поиск по FM-индексу вместо полного суффиксного массива
+    std::cin >> text >> pattern;
+    FMIndex index(text);
+    index.locate(pattern, positions);
+  } else {
+    std::cin >> text >> pattern;
+    findUsingSTL(text, pattern, positions);
   }
-  positions.assign(begin, end);
-}
-
-void find(const std::string &text, const std::string &pattern, std::vector < int > &positions) {
-  std::vector < int > suffArray;
-  suffixArray(text, suffArray);
-  int left = binSearch(text, pattern, suffArray, true);
-  int right = binSearch(text, pattern, suffArray, false);
-  if(left == right && text.substr(suffArray[left], pattern.size()) != pattern)
-    return;
-  for(int i = left; i <= right; i++)
-    positions.push_back(suffArray[i]);
-}
-
-int main() {
-  std::string text, pattern;
-  std::cin >> text >> pattern;
-  std::vector < int > positions;
-  findUsingSTL(text, pattern, positions);
   std::sort(positions.begin(), positions.end());
   for(int i = 0; i < positions.size(); i++)
     std::cout << positions[i] << ' ';
@@ -0,0 +1,238 @@
+#ifndef _SUFFIX_ARRAY_
+#define _SUFFIX_ARRAY_
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <map>
+
+// код символа при сортировке: 0 зарезервирован под терминатор
+int symbolCode(char symbol) {
+  return (unsigned char) symbol + 1;
+}
+
+template < class Symbol >
+int symbolCode(Symbol symbol) {
+  return (int) symbol + 1;
+}
+
+// символ с номером i, за концом последовательности - терминатор
+template < class Sequence >
+int symbolAt(const Sequence &s, int i) {
+  return i < (int) s.size() ? symbolCode(s[i]) : 0;
+}
+
+// суффиксный массив последовательности целых из [0..alphabetSize), например номеров слов.
+// Как и для строк, в массив входит пустой суффикс s.size()
+template < class Sequence >
+void suffixArray(const Sequence &s, std::vector < int > &suffArray, int alphabetSize) {
+  int strSize = s.size() + 1;
+  // + терминатор
+  alphabetSize++;
+  // число элементов в каждом классе эквивалентности
+  // изначально классы эквивалентности совпадают с буквами алфавита
+  std::vector < int > groups(alphabetSize, 0);
+  suffArray.assign(strSize, 0);
+  for(int i = 0; i < strSize; i++)
+    groups[symbolAt(s, i)]++;
+  // стабильная суффиксов сортировка подсчетом
+  for(int i = 1; i < alphabetSize; i++)
+    groups[i] += groups[i - 1];
+  for(int i = strSize - 1; i >= 0; i--)
+    suffArray[--groups[symbolAt(s, i)]] = i;
+  // класс эквивалентности элемента
+  std::vector < int > classes(strSize, 0);
+  for(int i = 1; i < strSize; i++) {
+    classes[suffArray[i]] = classes[suffArray[i - 1]];
+    if(symbolAt(s, suffArray[i]) != symbolAt(s, suffArray[i - 1]))
+      classes[suffArray[i]]++;
+  }
+  // классы эквивалентности следуюших подстрок
+  std::vector < int > newClasses;
+  // отсортированные 2-е строки
+  std::vector < int > newSuffArray(strSize);
+  for(int step = 0; 1 << step < strSize; step++) {
+    // сортируем 2-е строки
+    for(int i = 0; i < strSize; i++)
+      newSuffArray[i] = (suffArray[i] - (1 << step) + 2 * strSize) % strSize;
+    // стабильно сортируем 1-е строки
+    groups.assign(strSize, 0);
+    for(int i = 0; i < strSize; i++)
+      groups[classes[suffArray[i]]]++;
+    for(int i = 1; i < groups.size(); i++)
+      groups[i] += groups[i - 1];
+    for(int i = strSize - 1; i >= 0; i--)
+      suffArray[--groups[classes[newSuffArray[i]]]] = newSuffArray[i];
+    // обновим классы эквивалентности
+    newClasses.assign(strSize, 0);
+    for(int i = 1; i < strSize; i++) {
+      newClasses[suffArray[i]] = newClasses[suffArray[i - 1]];
+      if((classes[suffArray[i]] != classes[suffArray[i - 1]]) || 
+        (classes[(suffArray[i] + (1 << step)) % strSize] != classes[(suffArray[i - 1] + (1 << step)) % strSize]))
+        newClasses[suffArray[i]]++;
+    }
+    classes.swap(newClasses);
+  }
+}
+
+void suffixArray(const std::string &s, std::vector < int > &suffArray) {
+  suffixArray(s, suffArray, 1 << 8 * sizeof(char));
+}
+
+// lcp[i] - длина общего префикса суффиксов suffArray[i - 1] и suffArray[i], lcp[0] = 0.
+// Алгоритм Касаи: при переходе к следующему суффиксу текста общий префикс уменьшается не больше чем на 1
+template < class Sequence >
+void lcpArray(const Sequence &s, const std::vector < int > &suffArray, std::vector < int > &lcp) {
+  int strSize = suffArray.size();
+  std::vector < int > rank(strSize);
+  for(int i = 0; i < strSize; i++)
+    rank[suffArray[i]] = i;
+  lcp.assign(strSize, 0);
+  int common = 0;
+  for(int i = 0; i < strSize; i++) {
+    if(rank[i] == 0) {
+      common = 0;
+      continue;
+    }
+    int j = suffArray[rank[i] - 1];
+    // терминатор встречается один раз, поэтому за конец не выходим
+    while(symbolAt(s, i + common) != 0 && symbolAt(s, i + common) == symbolAt(s, j + common))
+      common++;
+    lcp[rank[i]] = common;
+    if(common > 0)
+      common--;
+  }
+}
+
+// наибольшая общая подстрока двух строк по суффиксному массиву склейки first#second, где # - символ 256,
+// которого нет в строках. Ответ - наибольший lcp соседних суффиксов из разных строк.
+// Возвращает длину, position - начало подстроки в first
+int longestCommonSubstring(const std::string &first, const std::string &second, int &position) {
+  std::vector < int > joined(first.size() + second.size() + 1);
+  for(int i = 0; i < first.size(); i++)
+    joined[i] = (unsigned char) first[i];
+  joined[first.size()] = 1 << 8 * sizeof(char);
+  for(int i = 0; i < second.size(); i++)
+    joined[first.size() + 1 + i] = (unsigned char) second[i];
+  std::vector < int > suffArray, lcp;
+  suffixArray(joined, suffArray, (1 << 8 * sizeof(char)) + 1);
+  lcpArray(joined, suffArray, lcp);
+  int best = 0;
+  position = 0;
+  for(int i = 1; i < suffArray.size(); i++) {
+    bool previousFirst = suffArray[i - 1] < (int) first.size();
+    bool currentFirst = suffArray[i] < (int) first.size();
+    if(previousFirst != currentFirst && lcp[i] > best) {
+      best = lcp[i];
+      position = currentFirst ? suffArray[i] : suffArray[i - 1];
+    }
+  }
+  return best;
+}
+
+template < class Sequence >
+int binSearch(const Sequence &text, const Sequence &pattern, const std::vector < int > &suffArray, bool isLower) {
+  // lower : (left...right]
+  // upper : [left...right)
+  int left = (isLower ? 0 : 1);
+  int right = text.size() + (isLower ? 0 : 1);
+  int matches = 0;
+  while(right - left > 1) {
+    int med = (left + right) / 2;
+    int medMatches;
+    // сравниваем, начиная с обшего префикса индексов
+    for(medMatches = matches; medMatches < pattern.size() &&
+      symbolCode(pattern[medMatches]) == symbolAt(text, (suffArray[med] + medMatches) % suffArray.size()); medMatches++);
+    if(isLower) {
+      if(medMatches != pattern.size() && symbolCode(pattern[medMatches]) > symbolAt(text, (suffArray[med] + medMatches) % suffArray.size()))
+        left = med;
+      else
+        right = med;
+    } else {
+      if(medMatches != pattern.size() && symbolCode(pattern[medMatches]) < symbolAt(text, (suffArray[med] + medMatches) % suffArray.size()))
+        right = med;
+      else
+        left = med;
+    }
+    //пересчитываем общий префикс индексов
+    while(matches < medMatches && right < suffArray.size() && 
+      symbolAt(text, (suffArray[left] + matches) % suffArray.size()) == symbolAt(text, (suffArray[right] + matches) % suffArray.size()))
+      matches++;
+  }
+  return isLower ? right : left;
+}
+
+class Functor {
+    const std::string &pattern;
+    const std::string &text;
+public:
+    bool operator()(int left, int right) {
+        if (left == -1) {
+            return pattern < text.substr(right, std::min(pattern.size(), text.size() - right));
+        } else if (right == -1) {
+            return text.substr(left, std::min(pattern.size(), text.size() - left)) < pattern;
+        } else {
+            return text.substr(left, std::min(pattern.size(), text.size() - left)) < 
+                text.substr(right, std::min(pattern.size(), text.size() - right));
+        }
+    }
+    Functor(const std::string &text, const std::string &pattern):
+        text(text),
+        pattern(pattern) {
+    }
+};
+
+void findUsingSTL(const std::string &text, const std::string &pattern, std::vector < int > &positions) {
+  std::vector < int > suffArray;
+  suffixArray(text, suffArray);
+  std::vector< int >::iterator begin;
+  std::vector< int >::iterator end;
+  Functor functor(text, pattern);
+  begin = std::lower_bound(suffArray.begin(), suffArray.end(), -1, functor);
+  end = std::upper_bound(suffArray.begin(), suffArray.end(), -1, functor);
+  if (begin != suffArray.end() && begin == end && text.substr(*begin, pattern.size()) != pattern) {
+      return;
+  }
+  positions.assign(begin, end);
+}
+
+void find(const std::string &text, const std::string &pattern, std::vector < int > &positions) {
+  std::vector < int > suffArray;
+  suffixArray(text, suffArray);
+  int left = binSearch(text, pattern, suffArray, true);
+  int right = binSearch(text, pattern, suffArray, false);
+  if(left == right && text.substr(suffArray[left], pattern.size()) != pattern)
+    return;
+  for(int i = left; i <= right; i++)
+    positions.push_back(suffArray[i]);
+}
+
+// поиск по последовательности целых из [0..alphabetSize), например фразы по номерам слов
+template < class Sequence >
+void find(const Sequence &text, const Sequence &pattern, int alphabetSize, std::vector < int > &positions) {
+  // в пустом тексте есть только суффикс-терминатор, binSearch вернул бы индекс за его концом
+  if(text.empty())
+    return;
+  std::vector < int > suffArray;
+  suffixArray(text, suffArray, alphabetSize);
+  int left = binSearch(text, pattern, suffArray, true);
+  int right = binSearch(text, pattern, suffArray, false);
+  if(left == right && (suffArray[left] + pattern.size() > text.size() ||
+    !std::equal(pattern.begin(), pattern.end(), text.begin() + suffArray[left])))
+    return;
+  for(int i = left; i <= right; i++)
+    positions.push_back(suffArray[i]);
+}
+
+// заменяет слова их номерами в словаре, новые слова добавляются. Возвращает размер словаря
+int tokenize(const std::vector < std::string > &words, std::map < std::string, int > &dictionary, std::vector < int > &tokens) {
+  for(int i = 0; i < words.size(); i++) {
+    std::map < std::string, int >::iterator it = dictionary.find(words[i]);
+    if(it == dictionary.end())
+      it = dictionary.insert(std::make_pair(words[i], (int) dictionary.size())).first;
+    tokens.push_back(it->second);
+  }
+  return dictionary.size();
+}
+
+#endif
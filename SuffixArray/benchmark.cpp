@@ -0,0 +1,208 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
+
+#include "SuffixArray.hpp"
+#include "FMIndex.hpp"
+#include "BenchmarkTexts.hpp"
+
+// замер построения и поиска по суффиксному массиву на стандартных входах
+// usage: benchmark [size] [queries] [csv|json] [file...]
+
+// суффиксный массив сортировкой сравнений, для проверки на небольших входах
+struct SuffixLess {
+  const std::string &text;
+  SuffixLess(const std::string &text): text(text) {}
+  bool operator()(int left, int right) const {
+    return text.compare(left, std::string::npos, text, right, std::string::npos) < 0;
+  }
+};
+
+void naiveSuffixArray(const std::string &text, std::vector < int > &suffArray) {
+  suffArray.resize(text.size() + 1);
+  for(int i = 0; i <= text.size(); i++)
+    suffArray[i] = i;
+  std::sort(suffArray.begin(), suffArray.end(), SuffixLess(text));
+}
+
+struct Result {
+  std::string input;
+  std::string algorithm;
+  std::string operation;
+  size_t size;
+  size_t count;
+  double seconds;
+  size_t memory;
+  bool agree;
+};
+
+void benchmark(const std::string &name, const std::string &text, size_t queries, std::vector < Result > &results) {
+  Result result;
+  result.input = name;
+  result.size = text.size();
+
+  result.operation = "build";
+  result.count = 1;
+  std::vector < int > suffArray;
+  clock_t begin = clock();
+  suffixArray(text, suffArray);
+  result.algorithm = "doubling";
+  result.seconds = elapsed(begin);
+  result.memory = suffArray.size() * sizeof(int) + text.size();
+  result.agree = true;
+  results.push_back(result);
+
+  std::vector < unsigned char > bytes(text.begin(), text.end());
+  std::vector < int > other;
+  begin = clock();
+  suffixArray(bytes, other, 1 << 8 * sizeof(char));
+  result.algorithm = "doubling-int";
+  result.seconds = elapsed(begin);
+  result.agree = other == suffArray;
+  results.push_back(result);
+
+  if(text.size() <= 5000) {
+    begin = clock();
+    naiveSuffixArray(text, other);
+    result.algorithm = "naive";
+    result.seconds = elapsed(begin);
+    result.agree = other == suffArray;
+    results.push_back(result);
+  }
+
+  begin = clock();
+  FMIndex index(text);
+  result.algorithm = "fm-index";
+  result.seconds = elapsed(begin);
+  result.memory = index.memory();
+  result.agree = true;
+  results.push_back(result);
+
+  // образцы - случайные подстроки текста
+  std::vector < std::string > patterns;
+  for(size_t i = 0; i < queries && text.size() > 0; i++) {
+    size_t length = std::min(text.size(), (size_t) 8);
+    patterns.push_back(text.substr(rand() % (text.size() - length + 1), length));
+  }
+  result.operation = "count";
+  result.count = patterns.size();
+  result.memory = suffArray.size() * sizeof(int) + text.size();
+  std::vector < size_t > occurrences(patterns.size());
+  begin = clock();
+  for(size_t i = 0; i < patterns.size(); i++)
+    occurrences[i] = binSearch(text, patterns[i], suffArray, false) - binSearch(text, patterns[i], suffArray, true) + 1;
+  result.algorithm = "binSearch";
+  result.seconds = elapsed(begin);
+  result.agree = true;
+  results.push_back(result);
+
+  std::vector < size_t > counts(patterns.size());
+  begin = clock();
+  for(size_t i = 0; i < patterns.size(); i++)
+    counts[i] = index.count(patterns[i]);
+  result.algorithm = "fm-index";
+  result.seconds = elapsed(begin);
+  result.memory = index.memory();
+  result.agree = counts == occurrences;
+  results.push_back(result);
+
+  // на периодичных строках у образца O(n) вхождений, поэтому ограничиваем их суммарное число
+  size_t located = 0, total = 0;
+  while(located < patterns.size() && total + occurrences[located] <= 4 * text.size() + queries)
+    total += occurrences[located++];
+  result.operation = "locate";
+  result.count = located;
+  result.memory = suffArray.size() * sizeof(int) + text.size();
+
+  std::vector < std::vector < int > > expected(located);
+  begin = clock();
+  for(size_t i = 0; i < located; i++) {
+    int left = binSearch(text, patterns[i], suffArray, true);
+    int right = binSearch(text, patterns[i], suffArray, false);
+    for(int j = left; j <= right; j++)
+      expected[i].push_back(suffArray[j]);
+  }
+  result.algorithm = "binSearch";
+  result.seconds = elapsed(begin);
+  result.agree = true;
+  results.push_back(result);
+
+  std::vector < std::vector < int > > found(located);
+  begin = clock();
+  for(size_t i = 0; i < located; i++) {
+    Functor functor(text, patterns[i]);
+    found[i].assign(std::lower_bound(suffArray.begin(), suffArray.end(), -1, functor),
+      std::upper_bound(suffArray.begin(), suffArray.end(), -1, functor));
+  }
+  result.algorithm = "stl";
+  result.seconds = elapsed(begin);
+  result.agree = found == expected;
+  results.push_back(result);
+
+  begin = clock();
+  for(size_t i = 0; i < located; i++) {
+    found[i].clear();
+    index.locate(patterns[i], found[i]);
+  }
+  result.algorithm = "fm-index";
+  result.seconds = elapsed(begin);
+  result.memory = index.memory();
+  result.agree = true;
+  for(size_t i = 0; i < located; i++) {
+    std::sort(found[i].begin(), found[i].end());
+    std::sort(expected[i].begin(), expected[i].end());
+    result.agree = result.agree && found[i] == expected[i];
+  }
+  results.push_back(result);
+}
+
+void printCSV(const std::vector < Result > &results) {
+  std::cout << "input,algorithm,operation,size,count,seconds,memory,agree" << std::endl;
+  for(size_t i = 0; i < results.size(); i++)
+    std::cout << results[i].input << ',' << results[i].algorithm << ',' << results[i].operation << ','
+      << results[i].size << ',' << results[i].count << ',' << results[i].seconds << ','
+      << results[i].memory << ',' << (results[i].agree ? "yes" : "no") << std::endl;
+}
+
+void printJSON(const std::vector < Result > &results) {
+  std::cout << '[' << std::endl;
+  for(size_t i = 0; i < results.size(); i++)
+    std::cout << "  {\"input\": \"" << results[i].input << "\", \"algorithm\": \"" << results[i].algorithm
+      << "\", \"operation\": \"" << results[i].operation << "\", \"size\": " << results[i].size
+      << ", \"count\": " << results[i].count << ", \"seconds\": " << results[i].seconds
+      << ", \"memory\": " << results[i].memory << ", \"agree\": " << (results[i].agree ? "true" : "false")
+      << '}' << (i + 1 < results.size() ? "," : "") << std::endl;
+  std::cout << ']' << std::endl;
+}
+
+int main(int argc, char **argv) {
+  size_t size = argc > 1 ? atol(argv[1]) : 1000000;
+  size_t queries = argc > 2 ? atol(argv[2]) : 10000;
+  std::string format = argc > 3 ? argv[3] : "csv";
+  srand(1);
+  std::vector < Result > results;
+  benchmark("random", randomString(size, "abcdefghijklmnopqrstuvwxyz"), queries, results);
+  benchmark("dna", randomString(size, "acgt"), queries, results);
+  benchmark("fibonacci", fibonacciString(size), queries, results);
+  benchmark("period", std::string(size, 'a'), queries, results);
+  // остальные аргументы - файлы с настоящим текстом
+  for(int i = 4; i < argc; i++) {
+    std::ifstream in(argv[i]);
+    std::stringstream text;
+    text << in.rdbuf();
+    benchmark(argv[i], text.str(), queries, results);
+  }
+  if(format == "json")
+    printJSON(results);
+  else
+    printCSV(results);
+  bool agree = true;
+  for(size_t i = 0; i < results.size(); i++)
+    agree = agree && results[i].agree;
+  return !agree;
+}
@@ -0,0 +1,59 @@
+#ifndef _GENERALIZED_SUFFIX_TREE_
+#define _GENERALIZED_SUFFIX_TREE_
+
+#include <vector>
+#include <string>
+
+#include "SuffixTree.hpp"
+
+// Обобщенное суффиксное дерево набора строк. Строки склеиваются через разделитель, в конце ставится
+// терминатор; это два наименьших байта, которых нет ни в одной строке. Если таких байтов нет,
+// дерево остается пустым и valid() возвращает false
+class GeneralizedSuffixTree {
+    SuffixTree tree;
+    // ends[d] - позиция разделителя после строки d
+    std::vector < size_t > ends;
+    bool built;
+public:
+    GeneralizedSuffixTree(const std::vector < std::string > &strings): built(false) {
+        std::vector < bool > used(1 << (8 * sizeof(char)), false);
+        for (size_t i = 0; i < strings.size(); i++)
+            for (size_t j = 0; j < strings[i].size(); j++)
+                used[(unsigned char) strings[i][j]] = true;
+        size_t separator = std::find(used.begin(), used.end(), false) - used.begin();
+        if (separator == used.size())
+            return;
+        used[separator] = true;
+        size_t terminator = std::find(used.begin(), used.end(), false) - used.begin();
+        if (terminator == used.size())
+            return;
+        for (size_t i = 0; i < strings.size(); i++) {
+            for (size_t j = 0; j < strings[i].size(); j++)
+                tree.append(strings[i][j]);
+            ends.push_back(tree.text().size());
+            tree.append((char) separator);
+        }
+        tree.append((char) terminator);
+        built = true;
+    }
+
+    // false, если в строках встречаются все байты, кроме разве что одного, и разделителям нет места
+    bool valid() const {
+        return built;
+    }
+
+    // наибольшая подстрока, которая встречается хотя бы в k строках, за один обход дерева
+    std::string longestCommonSubstring(size_t k) const {
+        if (!built)
+            return std::string();
+        size_t position;
+        size_t length = tree.commonSubstring(ends, k, position);
+        return tree.text().substr(position, length);
+    }
+
+    const SuffixTree &suffixTree() const {
+        return tree;
+    }
+};
+
+#endif
@@ -0,0 +1,647 @@
+#ifndef _SUFFIX_TREE_
+#define _SUFFIX_TREE_
+
+#include <vector>
+#include <string>
+#include <iostream>
+#include <algorithm>
+#include <fstream>
+#include <cstring>
+#include <cstddef>
+
+// Суффиксное дерево, строящееся алгоритмом Укконена по мере добавления букв.
+// Все данные лежат в объекте, поэтому несколько деревьев можно строить параллельно в разных потоках
+class SuffixTree {
+    friend class SuffixTreeImage;
+public:
+    static const size_t UNDEFINED = -1;
+    // конец листового ребра - растет вместе со строкой
+    static const size_t OPEN_END = -2;
+
+private:
+    enum { ROOT = 0, JOKER = 1 };
+
+    // Ребра всех вершин лежат в одном массиве edgeList, у вершины - номер первого ребра,
+    // у ребра - следующего ребра той же вершины. Список упорядочен по буквам.
+    // С -DDENSE_EDGES у вершины есть еще таблица на 256 букв: поиск ребра за O(1), но 2 КБ на вершину
+    struct Edge {
+        // [begin..end) - буквы из строки на ребре
+        size_t begin;
+        size_t end;
+        size_t target; // собственно, куда ведет
+        size_t next;   // следующее ребро из той же вершины
+        unsigned char letter; // первая буква на ребре
+        Edge(size_t begin, size_t end = OPEN_END, size_t target = UNDEFINED):
+            begin(begin),
+            end(end),
+            target(target),
+            next(UNDEFINED),
+            letter(0) {
+        }
+    };
+
+    struct Vertex {
+#ifdef DENSE_EDGES
+        std::vector < size_t > edges;
+#endif
+        size_t firstEdge;       // первое ребро в списке
+        size_t parent;          // откуда пришли
+        unsigned char letter;   // и по какой букве
+        size_t link;            // суффиксная ссылка
+        // следущие 3 поля не нужны для Укконена и считаются после построения дерева
+        size_t maxSubstr;       // днамика - наибоьшая общая побстрока, собираемая из этой вершины
+        bool containsFirst;     // достижим хотя бы 1 суффикс из 1-й строки
+        bool containsSecond;    // достижим хотя бы 1 суффикс ТОЛЬКО из 2-й строки
+        Vertex(size_t parent, unsigned char letter):
+#ifdef DENSE_EDGES
+            edges(1 << (8 * sizeof(char)), size_t(UNDEFINED)),
+#endif
+            firstEdge(UNDEFINED),
+            parent(parent),
+            letter(letter),
+            link(UNDEFINED),
+            maxSubstr(UNDEFINED),
+            containsFirst(false),
+            containsSecond(false) {
+        }
+    };
+
+    // позиция на ребре или в вершине
+    struct Position {
+        size_t vertex;          // откуда пришли
+        size_t shift;           // сколько прошли по ребру
+        unsigned char letter;   // с какой буквы начиналось ребро
+        // инвариант: 1) shift всегда меньше длины ребра
+        //            2) если shift == 0, то letter неопределено и не проверяется
+        Position(size_t vertex, size_t shift, unsigned char letter = 0):
+            vertex(vertex),
+            shift(shift),
+            letter(letter) {
+        }
+    };
+
+    // Дерево только для чтения: строка, ребра и первые ребра вершин. Через него на запросы отвечают
+    // и SuffixTree, и SuffixTreeImage, поэтому поиск написан один раз. Первое ребро вершины v лежит
+    // по адресу firstEdges + v * stride: в дереве это поле Vertex, в образе - массив size_t
+    struct View {
+        const char *str;
+        size_t strSize;
+        const Edge *edgeList;
+        const char *firstEdges;
+        size_t stride;
+        size_t leaves;
+#ifdef DENSE_EDGES
+        const Vertex *vertices; // таблицы ребер; в образе их нет, там NULL и поиск по списку
+#endif
+
+        size_t firstEdge(size_t vertex) const {
+            return *(const size_t *) (firstEdges + vertex * stride);
+        }
+
+        size_t getEdge(size_t vertex, unsigned char letter) const {
+            // все ребра из джокера - одно ребро 0 в корень
+            if (vertex == JOKER)
+                return 0;
+#ifdef DENSE_EDGES
+            if (vertices)
+                return vertices[vertex].edges[letter];
+#endif
+            size_t edge = firstEdge(vertex);
+            while (edge != UNDEFINED && edgeList[edge].letter < letter)
+                edge = edgeList[edge].next;
+            return edge != UNDEFINED && edgeList[edge].letter == letter ? edge : UNDEFINED;
+        }
+
+        size_t edgeLength(size_t edge) const {
+            return std::min(edgeList[edge].end, strSize) - edgeList[edge].begin;
+        }
+
+        // спускается из корня по pattern. false, если такого пути нет
+        bool locate(const std::string &pattern, Position &position) const {
+            position = Position(ROOT, 0);
+            for (size_t i = 0; i < pattern.size(); i++) {
+                unsigned char letter = position.shift ? position.letter : pattern[i];
+                size_t edge = getEdge(position.vertex, letter);
+                if (edge == UNDEFINED || position.shift == edgeLength(edge)
+                    || str[edgeList[edge].begin + position.shift] != pattern[i])
+                    return false;
+                position.letter = letter;
+                position.shift++;
+                if (position.shift == edgeLength(edge) && edgeList[edge].target != UNDEFINED)
+                    position = Position(edgeList[edge].target, 0);
+            }
+            return true;
+        }
+
+        // число вхождений: листья под позицией образца и суффиксы, которые еще не стали листьями
+        size_t countOccurrences(const std::string &pattern) const {
+            Position position(ROOT, 0);
+            if (pattern.empty() || !locate(pattern, position))
+                return 0;
+            size_t count = 0;
+            std::vector < size_t > stack;
+            if (position.shift) {
+                size_t edge = getEdge(position.vertex, position.letter);
+                if (edgeList[edge].target == UNDEFINED)
+                    count++;
+                else
+                    stack.push_back(edgeList[edge].target);
+            } else {
+                stack.push_back(position.vertex);
+            }
+            while (!stack.empty()) {
+                size_t vertex = stack.back();
+                stack.pop_back();
+                for (size_t i = firstEdge(vertex); i != UNDEFINED; i = edgeList[i].next) {
+                    if (edgeList[i].target == UNDEFINED)
+                        count++;
+                    else
+                        stack.push_back(edgeList[i].target);
+                }
+            }
+            for (size_t i = leaves; i + pattern.size() <= strSize; i++)
+                if (pattern.compare(0, pattern.size(), str + i, pattern.size()) == 0)
+                    count++;
+            return count;
+        }
+    };
+
+    // Образ дерева для SuffixTreeImage: заголовок, строка, ребра и первые ребра вершин.
+    // Каждый массив выровнен на 8 байт, числа - в порядке байт записавшей машины
+    struct ImageHeader {
+        char magic[8];
+        unsigned int version;
+        unsigned int byteOrder; // 0x01020304 глазами записавшей машины
+        unsigned int wordSize;  // sizeof(size_t)
+        unsigned int edgeSize;  // sizeof(Edge)
+        unsigned long long textSize;
+        unsigned long long edgesNumber;
+        unsigned long long verticesNumber;
+        unsigned long long leaves;
+    };
+
+    static void writeBlock(std::ostream &out, const void *data, size_t size) {
+        out.write((const char *) data, size);
+        for (; size % 8; size++)
+            out.put(0);
+    }
+
+    // Пишет массив записей, от каждой - первые used байт, остальное нули: иначе в файл попадало бы
+    // содержимое байт выравнивания, которые никто не инициализировал
+    template < class Record >
+    static void writeRecords(std::ostream &out, const Record *records, size_t count, size_t used) {
+        const size_t CHUNK = 1 << 12;
+        std::vector < char > buffer(std::min(count, CHUNK) * sizeof(Record), 0);
+        for (size_t i = 0; i < count; i += CHUNK) {
+            size_t chunk = std::min(count - i, CHUNK);
+            for (size_t j = 0; j < chunk; j++)
+                memcpy(&buffer[j * sizeof(Record)], records + i + j, used);
+            out.write(&buffer[0], chunk * sizeof(Record));
+        }
+        for (size_t size = count * sizeof(Record); size % 8; size++)
+            out.put(0);
+    }
+
+    std::string str;
+    std::vector < Edge > edgeList;
+    std::vector < Vertex > suffTree;
+    // позиция самого длинного суффикса, который еще не стал листом
+    Position current;
+    // число листьев; суффиксы [leaves..str.size()) пока заканчиваются внутри дерева
+    size_t leaves;
+
+    View view() const {
+        View view;
+        view.str = str.data();
+        view.strSize = str.size();
+        view.edgeList = &edgeList[0];
+        view.firstEdges = (const char *) &suffTree[0].firstEdge;
+        view.stride = sizeof(Vertex);
+        view.leaves = leaves;
+#ifdef DENSE_EDGES
+        view.vertices = &suffTree[0];
+#endif
+        return view;
+    }
+
+    // ребро из вершины по букве или UNDEFINED
+    size_t getEdge(size_t vertex, unsigned char letter) const {
+        return view().getEdge(vertex, letter);
+    }
+
+    // вставляет уже лежащее в edgeList ребро в список вершины
+    void setEdge(size_t vertex, unsigned char letter, size_t edge) {
+        edgeList[edge].letter = letter;
+#ifdef DENSE_EDGES
+        suffTree[vertex].edges[letter] = edge;
+#endif
+        size_t *place = &suffTree[vertex].firstEdge;
+        while (*place != UNDEFINED && edgeList[*place].letter < letter)
+            place = &edgeList[*place].next;
+        edgeList[edge].next = *place;
+        *place = edge;
+    }
+
+    // система непересекающихся множеств для commonSubstring
+    static size_t findSet(std::vector < size_t > &sets, size_t vertex) {
+        while (sets[vertex] != vertex) {
+            sets[vertex] = sets[sets[vertex]];
+            vertex = sets[vertex];
+        }
+        return vertex;
+    }
+
+    // длина ребра с учетом уже прочитанной части строки
+    size_t edgeLength(size_t edge) const {
+        return view().edgeLength(edge);
+    }
+
+    //пилим ребро, на котором сидим. возвращает новую вершину в середине ребра
+    size_t splitEdge(const Position &position) {
+        size_t currentEdge = getEdge(position.vertex, position.letter);
+
+        size_t cut = edgeList[currentEdge].begin + position.shift;
+        size_t newVertex = suffTree.size();
+        suffTree.push_back(Vertex(position.vertex, position.letter));
+
+        edgeList.push_back(edgeList[currentEdge]);
+        edgeList.back().begin = cut;
+        setEdge(newVertex, str[cut], edgeList.size() - 1);
+        size_t target = edgeList[currentEdge].target;
+        if (target != UNDEFINED) {
+            suffTree[target].parent = newVertex;
+            suffTree[target].letter = str[cut];
+        }
+
+        edgeList[currentEdge].end = cut;
+        edgeList[currentEdge].target = newVertex;
+        return newVertex;
+    }
+
+    // вершины передаются номерами: splitEdge может переложить suffTree в памяти
+    size_t getLink(size_t vertex) {
+        if (suffTree[vertex].link == UNDEFINED) {
+            // идем в ролителя, переходим по его ссылке
+            size_t parent = suffTree[vertex].parent;
+            size_t parentEdge = getEdge(parent, suffTree[vertex].letter);
+            size_t begin = edgeList[parentEdge].begin;
+            size_t end = edgeList[parentEdge].end;
+            size_t edgeSize = end - begin;
+            size_t parentLink = getLink(parent);
+            size_t visited = 0;
+            size_t nextEdge;
+            //спускаемся вниз из ссылки родителя по символам нашего ребра
+            while (visited < edgeSize) {
+                nextEdge = getEdge(parentLink, str[visited + begin]);
+                visited += edgeList[nextEdge].end - edgeList[nextEdge].begin;
+                if (visited > edgeSize) {
+                    // проскочили, вернемся назад
+                    visited -= edgeList[nextEdge].end - edgeList[nextEdge].begin;
+                    break;
+                }
+                parentLink = edgeList[nextEdge].target;
+            }
+            if (visited == edgeSize) {
+                suffTree[vertex].link = parentLink;
+            } else {
+                // придется порезать ребро, мы стоим в его центре
+                Position position(parentLink, edgeSize - visited, str[edgeList[nextEdge].begin]);
+                size_t link = splitEdge(position);
+                suffTree[vertex].link = link;
+            }
+        }
+        return suffTree[vertex].link;
+    }
+
+    //добавляем к дереву по букве
+    void add(Position &position, size_t letter) {
+        size_t vertex = position.vertex;
+        if (position.shift) {
+            Edge &edge = edgeList[getEdge(vertex, position.letter)];
+            if (str[edge.begin + position.shift] == str[letter]) {
+                // если стоим посреди ребра, и можем его не резать, то спустимся вниз и ничего не делаем
+                position.shift++;
+                if (edge.begin + position.shift == edge.end) {
+                    position = Position(edge.target, 0);
+                }
+                return;
+            }
+            // не можем спуститься по ребру, режем
+            vertex = splitEdge(position);
+        }
+        //пока нет ребра, добавим такое и спустимся по суффиксной ссылке
+        while (getEdge(vertex, str[letter]) == UNDEFINED) {
+            edgeList.push_back(Edge(letter));
+            setEdge(vertex, str[letter], edgeList.size() - 1);
+            leaves++;
+            vertex = getLink(vertex);
+        }
+        //нашли ребро, спускаемся по нему и завершаемся
+        position = Position(vertex, 1, str[letter]);
+        Edge &newEdge = edgeList[getEdge(vertex, str[letter])];
+        // грязный хак с joker и [UNDEFINED..0) ребром
+        if (newEdge.end - newEdge.begin == 1) {
+            position = Position(newEdge.target, 0);
+        }
+    }
+
+    // спуск на length букв str[begin..begin+length), которые точно есть на пути, прыжками по ребрам
+    Position descend(size_t vertex, size_t begin, size_t length) const {
+        while (length) {
+            size_t edge = getEdge(vertex, str[begin]);
+            size_t size = edgeLength(edge);
+            if (size > length || edgeList[edge].target == UNDEFINED)
+                return Position(vertex, length, str[begin]);
+            vertex = edgeList[edge].target;
+            begin += size;
+            length -= size;
+        }
+        return Position(vertex, 0);
+    }
+
+    void init() {
+        Vertex root(1, 0);
+        Vertex joker(UNDEFINED, 0);
+        root.parent = root.link = 1;
+        // все ребра по всем буквам ведут из joker в root
+        // на самом деле сошлемся на 1 ребро, оно все равно не будет меняться
+        edgeList.push_back(Edge(UNDEFINED, 0, 0));
+        suffTree.push_back(root);
+        suffTree.push_back(joker);
+    }
+
+public:
+    SuffixTree(): current(ROOT, 0), leaves(0) {
+        init();
+    }
+
+    SuffixTree(const std::string &text): current(ROOT, 0), leaves(0) {
+        init();
+        str.reserve(text.size());
+        for (size_t i = 0; i < text.size(); i++)
+            append(text[i]);
+    }
+
+    // онлайн-добавление буквы в конец строки
+    void append(char letter) {
+        str += letter;
+        add(current, str.size() - 1);
+    }
+
+    const std::string &text() const {
+        return str;
+    }
+
+    bool contains(const std::string &pattern) const {
+        Position position(ROOT, 0);
+        return view().locate(pattern, position);
+    }
+
+    // число вхождений: листья под позицией образца и суффиксы, которые еще не стали листьями
+    size_t countOccurrences(const std::string &pattern) const {
+        return view().countOccurrences(pattern);
+    }
+
+    // наибольшая общая подстрока текста и other за O(|other|) по суффиксным ссылкам.
+    // Возвращает длину, position - ее начало в тексте. Не const: досчитывает суффиксные ссылки
+    size_t longestCommonSubstring(const std::string &other, size_t &position) {
+        size_t best = 0;
+        position = 0;
+        // текущее совпадение - строка длины length, кончающаяся в вершине vertex или на ребре из нее
+        Position match(ROOT, 0);
+        size_t length = 0;
+        for (size_t i = 0; i < other.size(); i++) {
+            while (true) {
+                size_t edge = getEdge(match.vertex, match.shift ? match.letter : other[i]);
+                if (edge != UNDEFINED && match.shift < edgeLength(edge)
+                    && str[edgeList[edge].begin + match.shift] == other[i]) {
+                    match.letter = str[edgeList[edge].begin];
+                    match.shift++;
+                    length++;
+                    if (length > best) {
+                        best = length;
+                        position = edgeList[edge].begin + match.shift - length;
+                    }
+                    if (match.shift == edgeLength(edge) && edgeList[edge].target != UNDEFINED)
+                        match = Position(edgeList[edge].target, 0);
+                    break;
+                }
+                if (length == 0)
+                    break;
+                // отрезаем первую букву совпадения: переходим по суффиксной ссылке
+                length--;
+                size_t begin = match.shift ? edgeList[getEdge(match.vertex, match.letter)].begin : 0;
+                if (match.vertex == ROOT)
+                    match = descend(ROOT, begin + 1, match.shift - 1);
+                else
+                    match = descend(getLink(match.vertex), begin, match.shift);
+            }
+        }
+        return best;
+    }
+
+    // наибольшая общая подстрока двух строк, склеенных через разделители: str1 + '$' + str2 + '#'.
+    // size - длина str1. За один обход в обратном порядке (сначала дети, потом родитель) считает
+    // флаги containsFirst, containsSecond и maxSubstr. Без рекурсии, поэтому глубина дерева не важна
+    size_t findMaxSubstr(size_t size) {
+        std::vector < size_t > order;
+        order.push_back(ROOT);
+        for (size_t i = 0; i < order.size(); i++)
+            for (size_t j = suffTree[order[i]].firstEdge; j != UNDEFINED; j = edgeList[j].next)
+                if (edgeList[j].target != UNDEFINED)
+                    order.push_back(edgeList[j].target);
+        for (size_t i = order.size(); i > 0; i--) {
+            Vertex &vertex = suffTree[order[i - 1]];
+            for (size_t j = vertex.firstEdge; j != UNDEFINED; j = edgeList[j].next) {
+                Edge &edge = edgeList[j];
+                if (edge.target == UNDEFINED) {
+                    if (edge.begin <= size) {
+                        vertex.containsFirst = true;
+                    } else {
+                        vertex.containsSecond = true;
+                    }
+                } else {
+                    vertex.containsFirst = vertex.containsFirst || suffTree[edge.target].containsFirst;
+                    vertex.containsSecond = vertex.containsSecond || suffTree[edge.target].containsSecond;
+                }
+            }
+            //Если из вершины тостижимы только суффиксы из 1 слова, то UNDEFINED
+            if (!vertex.containsFirst || !vertex.containsSecond) {
+                continue;
+            }
+            vertex.maxSubstr = 0;
+            for (size_t j = vertex.firstEdge; j != UNDEFINED; j = edgeList[j].next) {
+                Edge &edge = edgeList[j];
+                if (edge.target != UNDEFINED && suffTree[edge.target].maxSubstr != UNDEFINED) {
+                    vertex.maxSubstr = std::max(vertex.maxSubstr, edge.end - edge.begin + suffTree[edge.target].maxSubstr);
+                }
+            }
+        }
+        return suffTree[ROOT].maxSubstr;
+    }
+
+    // подстрока, найденная findMaxSubstr: спуск по ребрам, на которых достигается максимум
+    std::string maxSubstr() const {
+        std::string result;
+        size_t position = ROOT;
+        while (suffTree[position].maxSubstr != 0 && suffTree[position].maxSubstr != UNDEFINED) {
+            const Vertex &vertex = suffTree[position];
+            size_t j = vertex.firstEdge;
+            for (; j != UNDEFINED; j = edgeList[j].next) {
+                const Edge &edge = edgeList[j];
+                if (edge.target != UNDEFINED && suffTree[edge.target].maxSubstr != UNDEFINED
+                    && suffTree[edge.target].maxSubstr + edge.end - edge.begin == vertex.maxSubstr) {
+                    break;
+                }
+            }
+            result.append(str, edgeList[j].begin, edgeList[j].end - edgeList[j].begin);
+            position = edgeList[j].target;
+        }
+        return result;
+    }
+
+    // Наибольшая подстрока, общая хотя бы k документам обобщенного дерева. Текст должен быть
+    // склейкой документов, после каждого - разделитель, в конце - уникальный терминатор, чтобы каждый
+    // суффикс стал листом. ends[d] - позиция разделителя после документа d.
+    // Число разных документов в поддереве считается как у Хуэя: листья одного документа в порядке
+    // обхода дают -1 в наименьшего общего предка соседних, предки ищутся офлайн алгоритмом Тарьяна.
+    // Возвращает длину, position - начало подстроки в тексте
+    size_t commonSubstring(const std::vector < size_t > &ends, size_t k, size_t &position) const {
+        size_t size = suffTree.size();
+        std::vector < size_t > depth(size, 0);       // длина строки до вершины
+        std::vector < size_t > leavesNumber(size, 0);
+        std::vector < size_t > duplicates(size, 0);  // сколько листьев - повторы документов
+        std::vector < size_t > sample(size, size_t(UNDEFINED)); // начало какого-нибудь суффикса в поддереве
+        std::vector < size_t > sets(size), ancestor(size);
+        std::vector < size_t > lastVertex(ends.size(), size_t(UNDEFINED));
+        std::vector < size_t > order;
+        // стек обхода: вершина и следующее ее ребро
+        std::vector < std::pair < size_t, size_t > > stack;
+        size_t best = 0;
+        position = 0;
+        stack.push_back(std::make_pair(size_t(ROOT), suffTree[ROOT].firstEdge));
+        sets[ROOT] = ancestor[ROOT] = ROOT;
+        while (!stack.empty()) {
+            size_t vertex = stack.back().first;
+            size_t edge = stack.back().second;
+            if (edge == UNDEFINED) {
+                stack.pop_back();
+                order.push_back(vertex);
+                if (!stack.empty()) {
+                    size_t parent = stack.back().first;
+                    sets[findSet(sets, vertex)] = findSet(sets, parent);
+                    ancestor[findSet(sets, parent)] = parent;
+                }
+                continue;
+            }
+            stack.back().second = edgeList[edge].next;
+            const Edge &next = edgeList[edge];
+            if (next.target != UNDEFINED) {
+                depth[next.target] = depth[vertex] + next.end - next.begin;
+                sets[next.target] = ancestor[next.target] = next.target;
+                stack.push_back(std::make_pair(next.target, suffTree[next.target].firstEdge));
+                continue;
+            }
+            size_t start = next.begin - depth[vertex];
+            size_t document = std::lower_bound(ends.begin(), ends.end(), start) - ends.begin();
+            // суффикс из одного терминатора
+            if (document == ends.size())
+                continue;
+            // лист - подстрока одного документа
+            if (k <= 1 && ends[document] - start > best) {
+                best = ends[document] - start;
+                position = start;
+            }
+            leavesNumber[vertex]++;
+            if (sample[vertex] == UNDEFINED)
+                sample[vertex] = start;
+            if (lastVertex[document] != UNDEFINED)
+                duplicates[ancestor[findSet(sets, lastVertex[document])]]++;
+            lastVertex[document] = vertex;
+        }
+        // дети идут в order раньше родителей
+        for (size_t i = 0; i < order.size(); i++) {
+            size_t vertex = order[i];
+            if (sample[vertex] != UNDEFINED && leavesNumber[vertex] - duplicates[vertex] >= k) {
+                // подстрока не должна заходить за разделитель
+                size_t document = std::lower_bound(ends.begin(), ends.end(), sample[vertex]) - ends.begin();
+                size_t length = std::min(depth[vertex], ends[document] - sample[vertex]);
+                if (length > best) {
+                    best = length;
+                    position = sample[vertex];
+                }
+            }
+            if (vertex != ROOT) {
+                size_t parent = suffTree[vertex].parent;
+                leavesNumber[parent] += leavesNumber[vertex];
+                duplicates[parent] += duplicates[vertex];
+                if (sample[parent] == UNDEFINED)
+                    sample[parent] = sample[vertex];
+            }
+        }
+        return best;
+    }
+
+    static const unsigned int IMAGE_VERSION = 1;
+
+    // пишет образ дерева, который SuffixTreeImage отображает в память без построения
+    bool save(const std::string &filename) const {
+        std::ofstream out(filename.c_str(), std::ios::binary);
+        ImageHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, "SUFTREE", 8);
+        header.version = IMAGE_VERSION;
+        header.byteOrder = 0x01020304;
+        header.wordSize = sizeof(size_t);
+        header.edgeSize = sizeof(Edge);
+        header.textSize = str.size();
+        header.edgesNumber = edgeList.size();
+        header.verticesNumber = suffTree.size();
+        header.leaves = leaves;
+        writeBlock(out, &header, sizeof(header));
+        writeBlock(out, str.data(), str.size());
+        writeRecords(out, &edgeList[0], edgeList.size(), offsetof(Edge, letter) + sizeof(unsigned char));
+        std::vector < size_t > firstEdges(suffTree.size());
+        for (size_t i = 0; i < suffTree.size(); i++)
+            firstEdges[i] = suffTree[i].firstEdge;
+        writeBlock(out, &firstEdges[0], firstEdges.size() * sizeof(size_t));
+        return out.good();
+    }
+
+    // память под дерево в байтах
+    size_t memory() const {
+        size_t memory = str.capacity() + edgeList.capacity() * sizeof(Edge) + suffTree.capacity() * sizeof(Vertex);
+#ifdef DENSE_EDGES
+        memory += suffTree.size() * (1 << (8 * sizeof(char))) * sizeof(size_t);
+#endif
+        return memory;
+    }
+
+    size_t verticesNumber() const {
+        return suffTree.size();
+    }
+
+    size_t edgesNumber() const {
+        return edgeList.size();
+    }
+
+    void print() const {
+        for (size_t i = 0; i < suffTree.size(); i++) {
+            std::cout << i << std::endl << ":";
+            // можно и не печатать ребра из joker
+            for (size_t j = suffTree[i].firstEdge; i != JOKER && j != UNDEFINED; j = edgeList[j].next) {
+                const Edge &edge = edgeList[j];
+                for (size_t k = edge.begin; k < std::min(edge.end, str.size()); k++)
+                    std::cout << str[k];
+                if (edge.target != UNDEFINED) {
+                    std::cout << edge.target;
+                }
+                std::cout << ' ';
+            }
+            std::cout << std::endl;
+        }
+        std::cout << std::endl;
+    }
+};
+
+#endif
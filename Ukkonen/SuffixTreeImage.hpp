@@ -0,0 +1,114 @@
+#ifndef _SUFFIX_TREE_IMAGE_
+#define _SUFFIX_TREE_IMAGE_
+
+#include <string>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "SuffixTree.hpp"
+
+// Суффиксное дерево, отображенное из файла SuffixTree::save только для чтения (mmap, POSIX).
+// Открытие не зависит от размера дерева: страницы подгружаются при первом обращении.
+// Поддерживает запросы, которым не нужны суффиксные ссылки
+class SuffixTreeImage {
+    typedef SuffixTree::Edge Edge;
+
+    void *image;
+    size_t imageSize;
+    // запросы - те же, что у SuffixTree, только по отображенным массивам
+    SuffixTree::View tree;
+    size_t verticesNumber_;
+
+    // отображение нельзя копировать
+    SuffixTreeImage(const SuffixTreeImage &);
+    SuffixTreeImage &operator=(const SuffixTreeImage &);
+
+    static size_t aligned(size_t size) {
+        return (size + 7) / 8 * 8;
+    }
+
+public:
+    SuffixTreeImage(): image(MAP_FAILED), imageSize(0) {
+    }
+
+    ~SuffixTreeImage() {
+        close();
+    }
+
+    // false, если файла нет, он обрезан или записан другой версией или на другой машине
+    bool open(const std::string &filename) {
+        close();
+        int file = ::open(filename.c_str(), O_RDONLY);
+        if (file < 0)
+            return false;
+        struct stat info;
+        if (fstat(file, &info) == 0 && (size_t) info.st_size >= sizeof(SuffixTree::ImageHeader)) {
+            imageSize = info.st_size;
+            image = mmap(NULL, imageSize, PROT_READ, MAP_SHARED, file, 0);
+        }
+        ::close(file);
+        if (image == MAP_FAILED)
+            return false;
+        const SuffixTree::ImageHeader *header = (const SuffixTree::ImageHeader *) image;
+        size_t expected = aligned(sizeof(*header)) + aligned(header->textSize)
+            + aligned(header->edgesNumber * sizeof(Edge)) + aligned(header->verticesNumber * sizeof(size_t));
+        if (memcmp(header->magic, "SUFTREE", 8) != 0 || header->version != SuffixTree::IMAGE_VERSION
+            || header->byteOrder != 0x01020304 || header->wordSize != sizeof(size_t)
+            || header->edgeSize != sizeof(Edge) || expected != imageSize) {
+            close();
+            return false;
+        }
+        const char *data = (const char *) image + aligned(sizeof(*header));
+        tree.str = data;
+        tree.strSize = header->textSize;
+        data += aligned(tree.strSize);
+        tree.edgeList = (const Edge *) data;
+        data += aligned(header->edgesNumber * sizeof(Edge));
+        tree.firstEdges = data;
+        tree.stride = sizeof(size_t);
+        tree.leaves = header->leaves;
+#ifdef DENSE_EDGES
+        tree.vertices = NULL;
+#endif
+        verticesNumber_ = header->verticesNumber;
+        return true;
+    }
+
+    void close() {
+        if (image != MAP_FAILED)
+            munmap(image, imageSize);
+        image = MAP_FAILED;
+        imageSize = 0;
+    }
+
+    bool isOpen() const {
+        return image != MAP_FAILED;
+    }
+
+    std::string text() const {
+        return std::string(tree.str, tree.strSize);
+    }
+
+    bool contains(const std::string &pattern) const {
+        SuffixTree::Position position(0, 0);
+        return tree.locate(pattern, position);
+    }
+
+    size_t countOccurrences(const std::string &pattern) const {
+        return tree.countOccurrences(pattern);
+    }
+
+    size_t verticesNumber() const {
+        return verticesNumber_;
+    }
+
+    size_t memory() const {
+        return imageSize;
+    }
+};
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef _AUTOMATON_FEDERATION_
+#define _AUTOMATON_FEDERATION_
+
+#include <string>
+#include <vector>
+#include <thread>
+
+#include "SuffixAutomaton.hpp"
+#include "../Parallel/ParallelFor.hpp"
+
+// Набор документов, у каждого свой суффиксный автомат. Автоматы независимы, поэтому строятся
+// параллельно через parallelFor (нужны -std=c++11 -pthread), и длинные документы не тормозят
+// остальные потоки. Запрос идет по всем автоматам за O(m * число документов)
+class AutomatonFederation {
+    std::vector < SuffixAutomaton > automata;
+public:
+    AutomatonFederation(const std::vector < std::string > &documents,
+                        size_t threadsNumber = std::thread::hardware_concurrency()): automata(documents.size()) {
+        parallelFor(documents.size(), threadsNumber, [&](size_t document) {
+            SuffixAutomaton automaton(documents[document]);
+            // числа вхождений тоже считаем здесь, иначе их посчитает первый запрос
+            automaton.computeOccurrences();
+            automata[document] = std::move(automaton);
+        });
+    }
+
+    size_t documentsNumber() const {
+        return automata.size();
+    }
+
+    const SuffixAutomaton &automaton(size_t document) const {
+        return automata[document];
+    }
+
+    bool contains(const std::string &pattern) const {
+        for (size_t i = 0; i < automata.size(); i++)
+            if (automata[i].contains(pattern))
+                return true;
+        return false;
+    }
+
+    // суммарное число вхождений во все документы
+    size_t countOccurrences(const std::string &pattern) {
+        size_t result = 0;
+        for (size_t i = 0; i < automata.size(); i++)
+            result += automata[i].countOccurrences(pattern);
+        return result;
+    }
+
+    // номера документов, в которых есть pattern, по возрастанию
+    void listDocuments(const std::string &pattern, std::vector < int > &documents) const {
+        for (size_t i = 0; i < automata.size(); i++)
+            if (automata[i].contains(pattern))
+                documents.push_back(i);
+    }
+
+    size_t memory() const {
+        size_t result = 0;
+        for (size_t i = 0; i < automata.size(); i++)
+            result += automata[i].memory();
+        return result;
+    }
+};
+
+#endif
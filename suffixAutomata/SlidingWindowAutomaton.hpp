@@ -0,0 +1,63 @@
+#ifndef _SLIDING_WINDOW_AUTOMATON_
+#define _SLIDING_WINDOW_AUTOMATON_
+
+#include <string>
+#include <utility>
+
+#include "SuffixAutomaton.hpp"
+
+// Поиск подстрок в последних window байтах бесконечного потока на двух суффиксных автоматах.
+// newer строится с начала текущего блока из window байт, older - с начала предыдущего, так что older
+// всегда содержит последние window байт, а всего - меньше 2 * window. Когда newer набирает window байт,
+// older выбрасывается, newer становится older, а новый блок начинается в освободившемся автомате.
+// Память - O(window), запрос - O(m) по older. Подстрока из последних window байт находится всегда,
+// но может найтись и та, что встречалась до 2 * window байт назад
+class SlidingWindowAutomaton {
+    size_t window;
+    SuffixAutomaton older, newer;
+public:
+    SlidingWindowAutomaton(size_t window): window(window) {
+    }
+
+    void append(char character) {
+        older.extend(character);
+        newer.extend(character);
+        if (newer.size() >= window) {
+            std::swap(older, newer);
+            newer.clear();
+        }
+    }
+
+    void append(const std::string &data) {
+        for (size_t i = 0; i < data.size(); i++)
+            append(data[i]);
+    }
+
+    // встречалась ли pattern в последних window байтах, за O(|pattern|)
+    bool contains(const std::string &pattern) const {
+        return pattern.size() <= window && older.contains(pattern);
+    }
+
+    // для дедупликации: была ли запись record в окне, после проверки она дописывается в поток.
+    // Записи разделяются delimiter, которого нет внутри записей, и поток начинается с него, поэтому ищется
+    // delimiter + record + delimiter: запись, совпавшая лишь с концом или началом другой, не считается виденной
+    bool appendIfSeen(const std::string &record, char delimiter = '\n') {
+        if (covered() == 0)
+            append(delimiter);
+        bool seen = contains(delimiter + record + delimiter);
+        append(record);
+        append(delimiter);
+        return seen;
+    }
+
+    // сколько последних байт потока сейчас проиндексировано: не меньше window (если столько пришло) и меньше 2 * window
+    size_t covered() const {
+        return older.size();
+    }
+
+    size_t memory() const {
+        return older.memory() + newer.memory();
+    }
+};
+
+#endif
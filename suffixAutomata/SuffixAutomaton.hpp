@@ -0,0 +1,451 @@
+#ifndef _SUFFIX_AUTOMATON_
+#define _SUFFIX_AUTOMATON_
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstring>
+#include <cstddef>
+#include <algorithm>
+
+// Суффиксный автомат строки, строится онлайн по букве.
+// Переходы всех вершин лежат в одном массиве transitions: у вершины - номер первого перехода,
+// у перехода - следующего перехода той же вершины, список упорядочен по буквам. У корня, через который
+// проходит почти каждое добавление, есть еще полная таблица на 256 букв.
+// Номера - 32-битные (Index), это вдвое экономит память. Переходов меньше 3n, и их номера должны
+// оставаться меньше UNDEFINED, поэтому строка - не длиннее MAX_SIZE (около 1.4 * 10^9 букв)
+class SuffixAutomaton {
+    friend class SuffixAutomatonImage;
+public:
+    typedef unsigned int Index;
+    static const Index UNDEFINED = Index(-1);
+    static const size_t MAX_SIZE = (size_t(UNDEFINED) - 1) / 3;
+
+private:
+    struct Transition {
+        Index target;
+        Index next;            // следующий переход из той же вершины
+        unsigned char letter;
+        Transition(unsigned char letter, Index target, Index next):
+            target(target),
+            next(next),
+            letter(letter) {
+        }
+    };
+
+    struct Vertex {
+        Index length;          // длина максимального пути до вершины
+        Index link;            // суффиксная ссылка
+        Index firstTransition; // первый переход в списке
+        Index firstPosition;   // где кончается первое вхождение; у клонов не равно length - 1
+        Vertex(Index length = 0, Index link = UNDEFINED, Index firstPosition = UNDEFINED):
+            length(length),
+            link(link),
+            firstTransition(UNDEFINED),
+            firstPosition(firstPosition) {
+        }
+    };
+
+    // Автомат только для чтения: через него на запросы отвечают и SuffixAutomaton, и SuffixAutomatonImage,
+    // поэтому поиск написан один раз
+    struct View {
+        const Vertex *suffAutomata;
+        const Transition *transitions;
+        const Index *rootTransitions;
+        const Index *occurrences; // NULL, пока числа вхождений не посчитаны
+
+        // номер перехода по букве или UNDEFINED
+        Index findTransition(Index vertex, unsigned char letter) const {
+            if (vertex == 0)
+                return rootTransitions[letter];
+            Index transition = suffAutomata[vertex].firstTransition;
+            while (transition != UNDEFINED && transitions[transition].letter < letter)
+                transition = transitions[transition].next;
+            return transition != UNDEFINED && transitions[transition].letter == letter ? transition : UNDEFINED;
+        }
+
+        Index next(Index vertex, unsigned char letter) const {
+            Index transition = findTransition(vertex, letter);
+            return transition == UNDEFINED ? UNDEFINED : transitions[transition].target;
+        }
+
+        // вершина, в которую ведет pattern из корня, или UNDEFINED
+        Index walk(const std::string &pattern) const {
+            Index vertex = 0;
+            for (size_t i = 0; i < pattern.size() && vertex != UNDEFINED; i++)
+                vertex = next(vertex, pattern[i]);
+            return vertex;
+        }
+
+        size_t firstOccurrence(const std::string &pattern) const {
+            Index vertex = walk(pattern);
+            if (vertex == UNDEFINED)
+                return std::string::npos;
+            if (pattern.empty())
+                return 0;
+            return suffAutomata[vertex].firstPosition + 1 - pattern.size();
+        }
+
+        // нужны посчитанные occurrences
+        size_t countOccurrences(const std::string &pattern) const {
+            Index vertex = walk(pattern);
+            if (vertex == UNDEFINED || pattern.empty())
+                return 0;
+            return occurrences[vertex];
+        }
+
+        size_t longestCommonSubstring(const std::string &text, size_t &position) const {
+            Index vertex = 0;
+            size_t length = 0, best = 0;
+            position = 0;
+            for (size_t i = 0; i < text.size(); i++) {
+                while (vertex != 0 && findTransition(vertex, text[i]) == UNDEFINED) {
+                    vertex = suffAutomata[vertex].link;
+                    length = suffAutomata[vertex].length;
+                }
+                if (findTransition(vertex, text[i]) != UNDEFINED) {
+                    vertex = next(vertex, text[i]);
+                    length++;
+                }
+                if (length > best) {
+                    best = length;
+                    position = suffAutomata[vertex].firstPosition + 1 - length;
+                }
+            }
+            return best;
+        }
+    };
+
+    // Образ автомата для SuffixAutomatonImage: заголовок, вершины, переходы, таблица корня и числа вхождений.
+    // Каждый массив выровнен на 8 байт, числа - в порядке байт записавшей машины
+    struct ImageHeader {
+        char magic[8];
+        unsigned int version;
+        unsigned int byteOrder; // 0x01020304 глазами записавшей машины
+        unsigned int vertexSize;
+        unsigned int transitionSize;
+        unsigned long long verticesNumber;
+        unsigned long long transitionsNumber;
+        unsigned long long lastVertex;
+    };
+
+    static void writeBlock(std::ostream &out, const void *data, size_t size) {
+        out.write((const char *) data, size);
+        for (; size % 8; size++)
+            out.put(0);
+    }
+
+    // Пишет массив записей, от каждой - первые used байт, остальное нули: иначе в файл попадало бы
+    // содержимое байт выравнивания, которые никто не инициализировал
+    template < class Record >
+    static void writeRecords(std::ostream &out, const Record *records, size_t count, size_t used) {
+        const size_t CHUNK = 1 << 12;
+        std::vector < char > buffer(std::min(count, CHUNK) * sizeof(Record), 0);
+        for (size_t i = 0; i < count; i += CHUNK) {
+            size_t chunk = std::min(count - i, CHUNK);
+            for (size_t j = 0; j < chunk; j++)
+                memcpy(&buffer[j * sizeof(Record)], records + i + j, used);
+            out.write(&buffer[0], chunk * sizeof(Record));
+        }
+        for (size_t size = count * sizeof(Record); size % 8; size++)
+            out.put(0);
+    }
+
+    std::vector < Vertex > suffAutomata;
+    std::vector < Transition > transitions;
+    // переходы корня по буквам
+    std::vector < Index > rootTransitions;
+    // вершина всей строки
+    Index lastVertex;
+    // occurrences[v] - число вхождений строк вершины, считается лениво
+    std::vector < Index > occurrences;
+    // paths[v] - число путей из вершины, включая пустой, тоже лениво
+    std::vector < size_t > paths;
+
+    View view() const {
+        View view;
+        view.suffAutomata = suffAutomata.data();
+        view.transitions = transitions.data();
+        view.rootTransitions = rootTransitions.data();
+        view.occurrences = occurrences.empty() ? NULL : occurrences.data();
+        return view;
+    }
+
+    // номер перехода по букве или UNDEFINED
+    Index findTransition(Index vertex, unsigned char letter) const {
+        return view().findTransition(vertex, letter);
+    }
+
+    // добавляет переход, которого еще нет
+    void addTransition(Index vertex, unsigned char letter, Index target) {
+        // previous - переход, после которого вставляем
+        Index previous = UNDEFINED;
+        Index following = suffAutomata[vertex].firstTransition;
+        while (following != UNDEFINED && transitions[following].letter < letter) {
+            previous = following;
+            following = transitions[following].next;
+        }
+        Index transition = transitions.size();
+        transitions.push_back(Transition(letter, target, following));
+        if (previous == UNDEFINED)
+            suffAutomata[vertex].firstTransition = transition;
+        else
+            transitions[previous].next = transition;
+        if (vertex == 0)
+            rootTransitions[letter] = transition;
+    }
+
+public:
+    // остаток по модулю Mod для countPaths, когда число путей не нужно точно
+    template < unsigned int Mod >
+    struct Modular {
+        unsigned int value;
+        Modular(size_t value = 0): value(value % Mod) {
+        }
+        Modular &operator+=(const Modular &other) {
+            value = (value + (unsigned long long) other.value) % Mod;
+            return *this;
+        }
+    };
+
+    SuffixAutomaton(): rootTransitions(1 << (8 * sizeof(char)), Index(UNDEFINED)), lastVertex(0) {
+        // корень
+        suffAutomata.push_back(Vertex());
+    }
+
+    SuffixAutomaton(const std::string &str): rootTransitions(1 << (8 * sizeof(char)), Index(UNDEFINED)), lastVertex(0) {
+        suffAutomata.push_back(Vertex());
+        // резерва под 2n вершин и 3n переходов нет: обычно их заметно меньше, а возврат лишнего
+        // копированием удвоил бы пик памяти как раз на длинных строках
+        for (size_t i = 0; i < str.size() && extend(str[i]); i++) {
+        }
+    }
+
+    // пустой автомат; память массивов остается за объектом и переиспользуется
+    void clear() {
+        suffAutomata.resize(1);
+        suffAutomata[0] = Vertex();
+        transitions.clear();
+        rootTransitions.assign(rootTransitions.size(), Index(UNDEFINED));
+        lastVertex = 0;
+        occurrences.clear();
+        paths.clear();
+    }
+
+    // добавление буквы в конец строки; false и ничего не меняет, если строка уже длины MAX_SIZE
+    bool extend(unsigned char character) {
+        if (size() >= MAX_SIZE)
+            return false;
+        occurrences.clear();
+        paths.clear();
+        Index newVertex = suffAutomata.size();
+        Index length = suffAutomata[lastVertex].length + 1;
+        suffAutomata.push_back(Vertex(length, UNDEFINED, length - 1));
+        // идем по суффиксным ссылкам и добавляем ребра в новую вершину, пока можно
+        Index vertex = lastVertex;
+        lastVertex = newVertex;
+        while (vertex != UNDEFINED && findTransition(vertex, character) == UNDEFINED) {
+            addTransition(vertex, character, newVertex);
+            vertex = suffAutomata[vertex].link;
+        }
+        if (vertex == UNDEFINED) {
+            // добавилась новая буква
+            suffAutomata[newVertex].link = 0;
+            return true;
+        }
+        // Из vertex уже есть переход по букве character в nextVertex
+        Index nextVertex = transitions[findTransition(vertex, character)].target;
+        if (suffAutomata[nextVertex].length == suffAutomata[vertex].length + 1) {
+            // в nextVertex ведет только сплошной путь, можно просто поставить ссылку
+            suffAutomata[newVertex].link = nextVertex;
+            return true;
+        }
+        // Пути, ведущие в nextVertex, слишком длинные. Склонируем вершину с меньшей длиной
+        Index clone = suffAutomata.size();
+        suffAutomata.push_back(Vertex(suffAutomata[vertex].length + 1, suffAutomata[nextVertex].link,
+                                      suffAutomata[nextVertex].firstPosition));
+        // копируем переходы, сохраняя порядок букв
+        Index tail = UNDEFINED;
+        for (Index i = suffAutomata[nextVertex].firstTransition; i != UNDEFINED; i = transitions[i].next) {
+            transitions.push_back(Transition(transitions[i].letter, transitions[i].target, UNDEFINED));
+            if (tail == UNDEFINED)
+                suffAutomata[clone].firstTransition = transitions.size() - 1;
+            else
+                transitions[tail].next = transitions.size() - 1;
+            tail = transitions.size() - 1;
+        }
+        suffAutomata[newVertex].link = clone;
+        suffAutomata[nextVertex].link = clone;
+        // перенаправляем в клон переходы, которые вели в nextVertex
+        while (vertex != UNDEFINED) {
+            Index transition = findTransition(vertex, character);
+            if (transitions[transition].target != nextVertex)
+                break;
+            transitions[transition].target = clone;
+            vertex = suffAutomata[vertex].link;
+        }
+        return true;
+    }
+
+    // переход по букве или UNDEFINED
+    Index next(Index vertex, unsigned char letter) const {
+        return view().next(vertex, letter);
+    }
+
+    bool contains(const std::string &pattern) const {
+        return view().walk(pattern) != UNDEFINED;
+    }
+
+    // начало первого вхождения или std::string::npos
+    size_t firstOccurrence(const std::string &pattern) const {
+        return view().firstOccurrence(pattern);
+    }
+
+    // число вхождений = число не клонов в поддереве суффиксных ссылок;
+    // вершины обходятся по убыванию length, для этого сортировка подсчетом
+    // Обычно зовется из countOccurrences, но можно и заранее, например в потоке, который строил автомат
+    void computeOccurrences() {
+        occurrences.assign(suffAutomata.size(), 0);
+        std::vector < Index > order;
+        sortByLength(order);
+        for (size_t i = order.size(); i > 1; i--) {
+            Index vertex = order[i - 1];
+            if (suffAutomata[vertex].firstPosition == suffAutomata[vertex].length - 1)
+                occurrences[vertex]++;
+            occurrences[suffAutomata[vertex].link] += occurrences[vertex];
+        }
+    }
+
+    // не const: при первом вызове после extend пересчитывает числа вхождений за O(n)
+    size_t countOccurrences(const std::string &pattern) {
+        if (occurrences.empty())
+            computeOccurrences();
+        return view().countOccurrences(pattern);
+    }
+
+    // наибольшая общая подстрока со строкой text за O(|text|).
+    // Возвращает длину, position - начало первого вхождения подстроки в строку автомата
+    size_t longestCommonSubstring(const std::string &text, size_t &position) const {
+        return view().longestCommonSubstring(text, position);
+    }
+
+    // число различных непустых подстрок: каждая вершина дает length(v) - length(link(v)) строк
+    size_t distinctSubstrings() const {
+        size_t result = 0;
+        for (size_t i = 1; i < suffAutomata.size(); i++)
+            result += suffAutomata[i].length - suffAutomata[suffAutomata[i].link].length;
+        return result;
+    }
+
+    // k-я в лексикографическом порядке различная подстрока, k с единицы; пустая, если k больше их числа.
+    // Переходы упорядочены по буквам, поэтому спуск идет за O(длина ответа * алфавит)
+    std::string kthSubstring(size_t k) {
+        if (paths.empty())
+            countPaths(paths);
+        std::string result;
+        if (k >= paths[0])
+            return result;
+        Index vertex = 0;
+        while (k > 0) {
+            for (Index i = suffAutomata[vertex].firstTransition; i != UNDEFINED; i = transitions[i].next) {
+                Index target = transitions[i].target;
+                if (paths[target] >= k) {
+                    result += transitions[i].letter;
+                    vertex = target;
+                    k--;
+                    break;
+                }
+                k -= paths[target];
+            }
+        }
+        return result;
+    }
+
+    // paths[v] - число путей из v, включая пустой, то есть число различных строк, которыми продолжаются
+    // строки вершины. Переходы ведут в вершины с большей length, поэтому считаем снизу вверх по убыванию
+    // length без рекурсии. Number - любой тип с += и конструктором от size_t: для size_t переполнения нет
+    // (путей из корня не больше n(n+1)/2+1), для счета по модулю есть Modular
+    template < class Number >
+    void countPaths(std::vector < Number > &paths) const {
+        std::vector < Index > order;
+        sortByLength(order);
+        paths.assign(suffAutomata.size(), Number(1));
+        for (size_t i = order.size(); i > 0; i--) {
+            Index vertex = order[i - 1];
+            for (Index j = suffAutomata[vertex].firstTransition; j != UNDEFINED; j = transitions[j].next)
+                paths[vertex] += paths[transitions[j].target];
+        }
+    }
+
+    // вершины по возрастанию length сортировкой подсчетом
+    void sortByLength(std::vector < Index > &order) const {
+        std::vector < Index > count(suffAutomata[lastVertex].length + 2, 0);
+        for (size_t i = 0; i < suffAutomata.size(); i++)
+            count[suffAutomata[i].length + 1]++;
+        for (size_t i = 1; i < count.size(); i++)
+            count[i] += count[i - 1];
+        order.resize(suffAutomata.size());
+        for (size_t i = 0; i < suffAutomata.size(); i++)
+            order[count[suffAutomata[i].length]++] = i;
+    }
+
+    static const unsigned int IMAGE_VERSION = 1;
+
+    // пишет образ автомата, который SuffixAutomatonImage отображает в память без построения.
+    // Не const: в образ входят числа вхождений, их может понадобиться досчитать
+    bool save(const std::string &filename) {
+        if (occurrences.empty())
+            computeOccurrences();
+        std::ofstream out(filename.c_str(), std::ios::binary);
+        ImageHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, "SUFAUTO", 8);
+        header.version = IMAGE_VERSION;
+        header.byteOrder = 0x01020304;
+        header.vertexSize = sizeof(Vertex);
+        header.transitionSize = sizeof(Transition);
+        header.verticesNumber = suffAutomata.size();
+        header.transitionsNumber = transitions.size();
+        header.lastVertex = lastVertex;
+        writeBlock(out, &header, sizeof(header));
+        writeRecords(out, suffAutomata.data(), suffAutomata.size(), offsetof(Vertex, firstPosition) + sizeof(Index));
+        writeRecords(out, transitions.data(), transitions.size(), offsetof(Transition, letter) + sizeof(unsigned char));
+        writeBlock(out, &rootTransitions[0], rootTransitions.size() * sizeof(Index));
+        writeBlock(out, &occurrences[0], occurrences.size() * sizeof(Index));
+        return out.good();
+    }
+
+    // длина проиндексированной строки
+    size_t size() const {
+        return suffAutomata[lastVertex].length;
+    }
+
+    size_t verticesNumber() const {
+        return suffAutomata.size();
+    }
+
+    size_t transitionsNumber() const {
+        return transitions.size();
+    }
+
+    // память в байтах
+    size_t memory() const {
+        return suffAutomata.capacity() * sizeof(Vertex) + transitions.capacity() * sizeof(Transition)
+            + rootTransitions.size() * sizeof(Index) + occurrences.capacity() * sizeof(Index)
+            + paths.capacity() * sizeof(size_t);
+    }
+
+    void print() const {
+        for (size_t i = 0; i < suffAutomata.size(); i++) {
+            std::cout << i << std::endl << ":";
+            for (Index j = suffAutomata[i].firstTransition; j != UNDEFINED; j = transitions[j].next) {
+                std::cout << transitions[j].letter << transitions[j].target << ' ';
+            }
+            std::cout << std::endl;
+        }
+        std::cout << std::endl;
+    }
+};
+
+#endif
@@ -0,0 +1,134 @@
+#ifndef _SUFFIX_AUTOMATON_IMAGE_
+#define _SUFFIX_AUTOMATON_IMAGE_
+
+#include <string>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "SuffixAutomaton.hpp"
+
+// Суффиксный автомат, отображенный из файла SuffixAutomaton::save только для чтения (mmap, POSIX).
+// Открытие не зависит от размера автомата: страницы подгружаются при первом обращении
+class SuffixAutomatonImage {
+    typedef SuffixAutomaton::Index Index;
+    typedef SuffixAutomaton::Vertex Vertex;
+    typedef SuffixAutomaton::Transition Transition;
+    static const Index UNDEFINED = SuffixAutomaton::UNDEFINED;
+
+    void *image;
+    size_t imageSize;
+    // запросы - те же, что у SuffixAutomaton, только по отображенным массивам
+    SuffixAutomaton::View automaton;
+    size_t verticesNumber_;
+    size_t transitionsNumber_;
+    Index lastVertex;
+
+    // отображение нельзя копировать
+    SuffixAutomatonImage(const SuffixAutomatonImage &);
+    SuffixAutomatonImage &operator=(const SuffixAutomatonImage &);
+
+    static size_t aligned(size_t size) {
+        return (size + 7) / 8 * 8;
+    }
+
+public:
+    SuffixAutomatonImage(): image(MAP_FAILED), imageSize(0) {
+    }
+
+    ~SuffixAutomatonImage() {
+        close();
+    }
+
+    // false, если файла нет, он обрезан или записан другой версией или на другой машине
+    bool open(const std::string &filename) {
+        close();
+        int file = ::open(filename.c_str(), O_RDONLY);
+        if (file < 0)
+            return false;
+        struct stat info;
+        if (fstat(file, &info) == 0 && (size_t) info.st_size >= sizeof(SuffixAutomaton::ImageHeader)) {
+            imageSize = info.st_size;
+            image = mmap(NULL, imageSize, PROT_READ, MAP_SHARED, file, 0);
+        }
+        ::close(file);
+        if (image == MAP_FAILED)
+            return false;
+        const SuffixAutomaton::ImageHeader *header = (const SuffixAutomaton::ImageHeader *) image;
+        size_t letters = 1 << (8 * sizeof(char));
+        size_t expected = aligned(sizeof(*header)) + aligned(header->verticesNumber * sizeof(Vertex))
+            + aligned(header->transitionsNumber * sizeof(Transition)) + aligned(letters * sizeof(Index))
+            + aligned(header->verticesNumber * sizeof(Index));
+        if (memcmp(header->magic, "SUFAUTO", 8) != 0 || header->version != SuffixAutomaton::IMAGE_VERSION
+            || header->byteOrder != 0x01020304 || header->vertexSize != sizeof(Vertex)
+            || header->transitionSize != sizeof(Transition) || expected != imageSize) {
+            close();
+            return false;
+        }
+        const char *data = (const char *) image + aligned(sizeof(*header));
+        automaton.suffAutomata = (const Vertex *) data;
+        data += aligned(header->verticesNumber * sizeof(Vertex));
+        automaton.transitions = (const Transition *) data;
+        data += aligned(header->transitionsNumber * sizeof(Transition));
+        automaton.rootTransitions = (const Index *) data;
+        data += aligned(letters * sizeof(Index));
+        automaton.occurrences = (const Index *) data;
+        verticesNumber_ = header->verticesNumber;
+        transitionsNumber_ = header->transitionsNumber;
+        lastVertex = header->lastVertex;
+        return true;
+    }
+
+    void close() {
+        if (image != MAP_FAILED)
+            munmap(image, imageSize);
+        image = MAP_FAILED;
+        imageSize = 0;
+    }
+
+    bool isOpen() const {
+        return image != MAP_FAILED;
+    }
+
+    Index next(Index vertex, unsigned char letter) const {
+        return automaton.next(vertex, letter);
+    }
+
+    bool contains(const std::string &pattern) const {
+        return automaton.walk(pattern) != UNDEFINED;
+    }
+
+    // как у SuffixAutomaton
+    size_t firstOccurrence(const std::string &pattern) const {
+        return automaton.firstOccurrence(pattern);
+    }
+
+    size_t countOccurrences(const std::string &pattern) const {
+        return automaton.countOccurrences(pattern);
+    }
+
+    size_t longestCommonSubstring(const std::string &text, size_t &position) const {
+        return automaton.longestCommonSubstring(text, position);
+    }
+
+    size_t size() const {
+        return automaton.suffAutomata[lastVertex].length;
+    }
+
+    size_t verticesNumber() const {
+        return verticesNumber_;
+    }
+
+    size_t transitionsNumber() const {
+        return transitionsNumber_;
+    }
+
+    size_t memory() const {
+        return imageSize;
+    }
+};
+
+#endif
@@ -1,104 +1,101 @@
 #include <iostream>
-#include <vector>
 #include <string>
+#include <vector>
+#include <cstdlib>
 
-const size_t UNDEFINED = -1;
-
-struct Vertex {
-    std::vector < size_t > edges;
-    size_t length;     //     
-    size_t link;       //  
-    size_t pathNumber; //  -     
-    Vertex(size_t length = 0, size_t link = UNDEFINED):
-        edges(1 << (8 * sizeof(char)), UNDEFINED),
-        length(length),
-        link(link),
-        pathNumber(UNDEFINED) {
-    }
-};
-
-std::vector < Vertex > suffAutomata;
-
-size_t init() {
-    // 
-    suffAutomata.push_back(Vertex());
-    return 0;
-}
+#include "SuffixAutomaton.hpp"
+#include "SlidingWindowAutomaton.hpp"
+#include "AutomatonFederation.hpp"
+#include "SuffixAutomatonImage.hpp"
 
-size_t addNextCharacter(size_t lastVertex, unsigned char character) {
-    size_t newVertex = suffAutomata.size();
-    suffAutomata.push_back(Vertex(suffAutomata[lastVertex].length + 1));
-    //          ,  
-    while (lastVertex != UNDEFINED && suffAutomata[lastVertex].edges[character] == UNDEFINED) {
-        suffAutomata[lastVertex].edges[character] = newVertex;
-        lastVertex = suffAutomata[lastVertex].link;
-    }
-    if (lastVertex == UNDEFINED) {
-        //   
-        suffAutomata[newVertex].link = 0;
-        return newVertex;
+// usage: suffixAutomata            - автомат строки и число ее различных подстрок
+//        suffixAutomata find       - строка, затем образцы до конца ввода: вхождения и первое из них
+//        suffixAutomata lcs        - две строки, их наибольшая общая подстрока
+//        suffixAutomata window W   - записи до конца ввода, печатаются те, которых не было в последних W байтах
+//        suffixAutomata docs       - N, N документов, затем образцы: вхождения во все документы и список документов
+//        suffixAutomata save file  - строка; автомат пишется образом в file
+//        suffixAutomata query file - образ из file, затем образцы: вхождения и первое из них
+//        suffixAutomata kth        - строка, затем числа k: k-я в лексикографическом порядке подстрока
+int main(int argc, char **argv) {
+    std::string mode = argc > 1 ? argv[1] : "";
+    if (mode == "window") {
+        SlidingWindowAutomaton automaton(argc > 2 ? atol(argv[2]) : 1 << 20);
+        std::string record;
+        while (std::cin >> record)
+            if (!automaton.appendIfSeen(record))
+                std::cout << record << std::endl;
+        return 0;
     }
-    //  lastVertex      charcter  nextVertex
-    size_t nextVertex = suffAutomata[lastVertex].edges[character];
-    if (suffAutomata[nextVertex].length == suffAutomata[lastVertex].length + 1) {
-        //  nextVertex    ,       
-        suffAutomata[newVertex].link = nextVertex;
-        return newVertex;
+    if (mode == "docs") {
+        size_t n;
+        std::cin >> n;
+        std::vector < std::string > documents(n);
+        for (size_t i = 0; i < n; i++)
+            std::cin >> documents[i];
+        AutomatonFederation federation(documents);
+        std::string pattern;
+        while (std::cin >> pattern) {
+            std::vector < int > found;
+            federation.listDocuments(pattern, found);
+            std::cout << federation.countOccurrences(pattern) << ':';
+            for (size_t i = 0; i < found.size(); i++)
+                std::cout << ' ' << found[i];
+            std::cout << std::endl;
+        }
+        return 0;
     }
-    //  ,   nextVertex  .    
-    size_t clone = suffAutomata.size();
-    suffAutomata.push_back(suffAutomata[nextVertex]);
-    suffAutomata[clone].length = suffAutomata[lastVertex].length + 1;
-    suffAutomata[newVertex].link = clone;
-    suffAutomata[nextVertex].link = clone;
-    while (lastVertex != UNDEFINED && suffAutomata[lastVertex].edges[character] == nextVertex) {
-        suffAutomata[lastVertex].edges[character] = clone;
-        lastVertex = suffAutomata[lastVertex].link;
+    if (mode == "query" && argc > 2) {
+        SuffixAutomatonImage image;
+        if (!image.open(argv[2])) {
+            std::cerr << "cannot open image " << argv[2] << std::endl;
+            return 1;
+        }
+        std::string pattern;
+        while (std::cin >> pattern) {
+            std::cout << image.countOccurrences(pattern) << ' ';
+            size_t position = image.firstOccurrence(pattern);
+            if (position == std::string::npos)
+                std::cout << -1 << std::endl;
+            else
+                std::cout << position << std::endl;
+        }
+        return 0;
     }
-    return newVertex;
-}
-
-size_t buildSuffAutomata(const std::string &str) {
-    // ,    
-    size_t lastVertex = init();
-    for (size_t i = 0; i < str.size(); i++) {
-        lastVertex = addNextCharacter(lastVertex, str[i]);
+    std::string str;
+    std::cin >> str;
+    if (str.size() > SuffixAutomaton::MAX_SIZE) {
+        std::cerr << "string is too long" << std::endl;
+        return 1;
     }
-    return lastVertex;
-}
-
-size_t pathNumber(size_t vertex) {
-    if (vertex == UNDEFINED) {
-        return 0;
-    } else {
-        if (suffAutomata[vertex].pathNumber == UNDEFINED) {
-            suffAutomata[vertex].pathNumber = 1;
-            for (size_t i = 0; i < suffAutomata[vertex].edges.size(); i++) {
-                suffAutomata[vertex].pathNumber += pathNumber(suffAutomata[vertex].edges[i]);
-            }
+    SuffixAutomaton automaton(str);
+    if (mode == "save" && argc > 2) {
+        if (!automaton.save(argv[2])) {
+            std::cerr << "cannot write " << argv[2] << std::endl;
+            return 1;
         }
-        return suffAutomata[vertex].pathNumber;
-    }
-}
-
-void printSuffAutomata() {
-    for (size_t i = 0; i < suffAutomata.size(); i++) {
-        std::cout << i << std::endl << ":";
-        for (size_t j = 0; j < suffAutomata[i].edges.size(); j++) {
-            if (suffAutomata[i].edges[j] != UNDEFINED) {
-                std::cout << (unsigned char) j << suffAutomata[i].edges[j] << ' ';
-            }
+    } else if (mode == "find") {
+        std::string pattern;
+        while (std::cin >> pattern) {
+            std::cout << automaton.countOccurrences(pattern) << ' ';
+            size_t position = automaton.firstOccurrence(pattern);
+            if (position == std::string::npos)
+                std::cout << -1 << std::endl;
+            else
+                std::cout << position << std::endl;
         }
-        std::cout << std::endl;
+    } else if (mode == "lcs") {
+        std::string text;
+        std::cin >> text;
+        size_t position;
+        size_t length = automaton.longestCommonSubstring(text, position);
+        std::cout << str.substr(position, length) << std::endl;
+    } else if (mode == "kth") {
+        size_t k;
+        while (std::cin >> k)
+            std::cout << automaton.kthSubstring(k) << std::endl;
+    } else {
+        automaton.print();
+        std::cout << automaton.distinctSubstrings() << std::endl;
     }
-    std::cout << std::endl;
+    return 0;
 }
-
-void main() {
-    std::string str;
-    std::cin >> str;
-    buildSuffAutomata(str);
-    printSuffAutomata();
-    //  
-    std::cout << pathNumber(0) - 1 << std::endl;
-}
\ No newline at end of file